@@ -46,12 +46,14 @@
 #include <QStringList>
 #include <QDebug>
 #include <QStyleFactory>
+#include <QtConcurrentRun>
 
 #include "InstanceList.h"
 
 #include <minecraft/auth/AccountList.h>
 #include "icons/IconList.h"
 #include "net/HttpMetaCache.h"
+#include "net/ObjectStore.h"
 
 #include "java/JavaUtils.h"
 
@@ -653,7 +655,9 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
 
     // Initialize application settings
     {
-        m_settings.reset(new INISettingsObject(BuildConfig.LAUNCHER_CONFIGFILE, this));
+        auto launcherSettings = new INISettingsObject(BuildConfig.LAUNCHER_CONFIGFILE, this);
+        launcherSettings->setWriteBehind(true);
+        m_settings.reset(launcherSettings);
         // Updates
         m_settings->registerSetting("AutoUpdate", true);
 
@@ -693,6 +697,7 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
         m_settings->registerSetting("ConsoleFontSize", defaultSize);
         m_settings->registerSetting("ConsoleMaxLines", 100000);
         m_settings->registerSetting("ConsoleOverflowStop", true);
+        m_settings->registerSetting("ConsoleLogToDisk", false);
 
         // Folders
         m_settings->registerSetting("InstanceDir", "instances");
@@ -702,6 +707,12 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
         // Editors
         m_settings->registerSetting("JsonEditor", QString());
 
+        // Minutes between checks for metadata updates when launching unchanged instances, 0 checks on every launch
+        m_settings->registerSetting("MetadataRefreshInterval", 1440);
+
+        // MiB the shared download object store may take up before the least recently used objects go, 0 for no limit
+        m_settings->registerSetting("ObjectStoreMaxSize", 4096);
+
         // Language
         m_settings->registerSetting("Language", QString());
 
@@ -897,10 +908,10 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
             qWarning() << "Your instance path contains \'!\' and this is known to cause java problems!";
         }
         m_instances.reset(new InstanceList(m_settings, instDir, this));
+        m_instances->setSummaryIndexPath(QDir("cache/instances.idx").absolutePath());
         connect(InstDirSetting.get(), &Setting::SettingChanged, m_instances.get(), &InstanceList::on_InstFolderChanged);
-        qDebug() << "Loading Instances...";
-        m_instances->loadList();
-        qDebug() << "<> Instances loaded.";
+        qDebug() << "Loading Instances in the background...";
+        m_instances->loadListAsync();
     }
 
     // and accounts
@@ -931,8 +942,17 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv)
         m_metacache->addBase("root", QDir::currentPath());
         m_metacache->addBase("translations", QDir("translations").absolutePath());
         m_metacache->addBase("icons", QDir("cache/icons").absolutePath());
+        m_metacache->addBase("jarmods", QDir("cache/jarmods").absolutePath());
+        m_metacache->addBase("natives", QDir("cache/natives").absolutePath());
         m_metacache->addBase("meta", QDir("meta").absolutePath());
         m_metacache->Load();
+        Net::ObjectStore::global().setRoot(QDir("cache/objects").absolutePath());
+        // keep the store from growing forever, without holding up the startup
+        qint64 objectStoreMaxSize = m_settings->get("ObjectStoreMaxSize").toLongLong() * 1024 * 1024;
+        QtConcurrent::run([objectStoreMaxSize]()
+        {
+            Net::ObjectStore::global().pruneIfDue(objectStoreMaxSize);
+        });
         qDebug() << "<> Cache initialized.";
     }
 
@@ -1097,6 +1117,7 @@ void Application::performMainStartupAction()
     m_status = Application::Initialized;
     if(!m_instanceIdToLaunch.isEmpty())
     {
+        instances()->waitForLoad();
         auto inst = instances()->getInstanceById(m_instanceIdToLaunch);
         if(inst)
         {
@@ -1153,6 +1174,9 @@ void Application::showFatalErrorMessage(const QString& title, const QString& con
 
 Application::~Application()
 {
+    // don't lose settings changes that are still waiting to be written
+    INISettingsObject::flushAll();
+
     // Shut down logger by setting the logger function to nothing
     qInstallMessageHandler(nullptr);
 
@@ -1206,6 +1230,7 @@ void Application::messageReceived(const QByteArray& message)
 
         InstancePtr instance;
         if(!id.isEmpty()) {
+            instances()->waitForLoad();
             instance = instances()->getInstanceById(id);
             if(!instance) {
                 qWarning() << "Launch command requires an valid instance ID. " << id << "resolves to nothing.";
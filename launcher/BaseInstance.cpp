@@ -56,6 +56,7 @@ BaseInstance::BaseInstance(SettingsObjectPtr globalSettings, SettingsObjectPtr s
 
     m_settings->registerPassthrough(globalSettings->getSetting("ConsoleMaxLines"), nullptr);
     m_settings->registerPassthrough(globalSettings->getSetting("ConsoleOverflowStop"), nullptr);
+    m_settings->registerPassthrough(globalSettings->getSetting("ConsoleLogToDisk"), nullptr);
 
     // Managed Packs
     m_settings->registerSetting("ManagedPack", false);
@@ -139,6 +140,22 @@ bool BaseInstance::shouldStopOnConsoleOverflow() const
     return settings()->get("ConsoleOverflowStop").toBool();
 }
 
+bool BaseInstance::shouldLogConsoleToDisk() const
+{
+    return settings()->get("ConsoleLogToDisk").toBool();
+}
+
+QString BaseInstance::consoleLogStorePath() const
+{
+    // not in the instance folder, so it isn't copied or exported along with the instance
+    return QDir("cache/logs").absoluteFilePath(id() + ".mmclog");
+}
+
+QString BaseInstance::cacheRoot() const
+{
+    return QDir("cache/instances").absoluteFilePath(id());
+}
+
 void BaseInstance::iconUpdated(QString key)
 {
     if(iconKey() == key)
@@ -245,6 +245,11 @@ public:
 
     int getConsoleMaxLines() const;
     bool shouldStopOnConsoleOverflow() const;
+    bool shouldLogConsoleToDisk() const;
+    /// Where the whole log of the last launch is kept, see LogStore
+    QString consoleLogStorePath() const;
+    /// Where caches of this instance go. Not in the instance folder, so they aren't copied or exported along with it.
+    QString cacheRoot() const;
 
 protected:
     void changeStatus(Status newStatus);
@@ -23,6 +23,13 @@
     #include <shlobj.h>
 #else
     #include <utime.h>
+    #include <unistd.h>
+    #include <fcntl.h>
+#endif
+
+#if defined Q_OS_LINUX
+    #include <sys/ioctl.h>
+    #include <linux/fs.h>
 #endif
 
 namespace FS {
@@ -171,6 +178,94 @@ bool copy::operator()(const QString &offset)
     return true;
 }
 
+namespace {
+bool reflinkFile(const QString &src, const QString &dst)
+{
+#if defined(Q_OS_LINUX) && defined(FICLONE)
+    QByteArray srcBA = QFile::encodeName(src);
+    QByteArray dstBA = QFile::encodeName(dst);
+    int srcFd = ::open(srcBA.constData(), O_RDONLY);
+    if(srcFd < 0)
+    {
+        return false;
+    }
+    int dstFd = ::open(dstBA.constData(), O_WRONLY | O_CREAT | O_EXCL, 0644);
+    if(dstFd < 0)
+    {
+        ::close(srcFd);
+        return false;
+    }
+    bool ok = ::ioctl(dstFd, FICLONE, srcFd) == 0;
+    ::close(srcFd);
+    ::close(dstFd);
+    if(!ok)
+    {
+        ::unlink(dstBA.constData());
+    }
+    return ok;
+#else
+    Q_UNUSED(src);
+    Q_UNUSED(dst);
+    return false;
+#endif
+}
+
+bool hardlinkFile(const QString &src, const QString &dst)
+{
+#if defined Q_OS_WIN32
+    std::wstring srcW = QDir::toNativeSeparators(src).toStdWString();
+    std::wstring dstW = QDir::toNativeSeparators(dst).toStdWString();
+    return CreateHardLinkW(dstW.c_str(), srcW.c_str(), nullptr);
+#else
+    QByteArray srcBA = QFile::encodeName(src);
+    QByteArray dstBA = QFile::encodeName(dst);
+    return ::link(srcBA.constData(), dstBA.constData()) == 0;
+#endif
+}
+
+
+bool prepareTarget(const QString &dst)
+{
+    if (!ensureFilePathExists(dst))
+    {
+        qWarning() << "Cannot create path for" << dst;
+        return false;
+    }
+    if (QFileInfo::exists(dst) && !QFile::remove(dst))
+    {
+        qWarning() << "Cannot replace" << dst;
+        return false;
+    }
+    return true;
+}
+}
+
+bool linkOrCopy(const QString &src, const QString &dst)
+{
+    if (!prepareTarget(dst))
+    {
+        return false;
+    }
+    if(reflinkFile(src, dst) || hardlinkFile(src, dst))
+    {
+        return true;
+    }
+    return QFile::copy(src, dst);
+}
+
+bool reflinkOrCopy(const QString &src, const QString &dst)
+{
+    if (!prepareTarget(dst))
+    {
+        return false;
+    }
+    if(reflinkFile(src, dst))
+    {
+        return true;
+    }
+    return QFile::copy(src, dst);
+}
+
 bool deletePath(QString path)
 {
     bool OK = true;
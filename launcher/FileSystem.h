@@ -77,6 +77,20 @@ private:
     QDir m_dst;
 };
 
+/**
+ * Make the file at dst have the same content as src, replacing dst if it exists.
+ *
+ * Uses a reflink if the filesystem supports it, a hard link if src and dst are on
+ * the same filesystem and falls back to a plain copy otherwise.
+ * Hard linked files share their data, so only use this for files that are replaced, not modified in place.
+ */
+bool linkOrCopy(const QString &src, const QString &dst);
+
+/**
+ * Like linkOrCopy, but never hard links. Use this when dst may be modified in place.
+ */
+bool reflinkOrCopy(const QString &src, const QString &dst);
+
 /**
  * Delete a folder recursively
  */
@@ -22,6 +22,7 @@ InstanceCopyTask::InstanceCopyTask(InstancePtr origInstance, bool copySaves, boo
 void InstanceCopyTask::executeTask()
 {
     setStatus(tr("Copying instance %1").arg(m_origInstance->name()));
+    INISettingsObject::flushAll();
 
     FS::copy folderCopy(m_origInstance->instanceRoot(), m_stagingPath);
     folderCopy.followSymlinks(false).blacklist(m_matcher.get());
@@ -27,6 +27,7 @@
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QMimeData>
+#include <QtConcurrent>
 
 #include "InstanceList.h"
 #include "BaseInstance.h"
@@ -58,10 +59,51 @@ InstanceList::InstanceList(SettingsObjectPtr settings, const QString & instDir,
     m_watcher = new QFileSystemWatcher(this);
     connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &InstanceList::instanceDirContentsChanged);
     m_watcher->addPath(m_instDir);
+
+    m_loadPool.setMaxThreadCount(qBound(4, QThread::idealThreadCount() * 2, 16));
+    connect(&m_discoveryWatcher, &QFutureWatcher<DiscoveryResult>::finished, this, &InstanceList::discoveryFinished);
+
+    m_summarySaveTimer.setSingleShot(true);
+    m_summarySaveTimer.setInterval(5000);
+    connect(&m_summarySaveTimer, &QTimer::timeout, this, &InstanceList::saveSummaryIndex);
 }
 
 InstanceList::~InstanceList()
 {
+    m_discoveryWatcher.waitForFinished();
+    m_loadPool.waitForDone();
+    if(m_summarySaveTimer.isActive())
+    {
+        saveSummaryIndex();
+    }
+}
+
+void InstanceList::setSummaryIndexPath(const QString& path)
+{
+    m_summaryIndexPath = path;
+}
+
+void InstanceList::saveSummaryIndex()
+{
+    m_summarySaveTimer.stop();
+    if(m_summaryIndexPath.isEmpty() || m_loading)
+    {
+        return;
+    }
+    InstanceSummaryIndex::Entries entries;
+    for(auto & instance: m_instances)
+    {
+        auto settings = std::dynamic_pointer_cast<INISettingsObject>(instance->settings());
+        if(!settings || settings->fileStamp() == 0)
+        {
+            continue;
+        }
+        InstanceSummaryIndex::Entry entry;
+        entry.stamp = settings->fileStamp();
+        entry.values = settings->values(InstanceSummaryIndex::summaryKeys());
+        entries.insert(instance->id(), entry);
+    }
+    InstanceSummaryIndex::save(m_summaryIndexPath, m_instDir, entries);
 }
 
 Qt::DropActions InstanceList::supportedDragActions() const
@@ -298,11 +340,16 @@ void InstanceList::deleteInstance(const InstanceId& id)
     }
 
     qDebug() << "Will delete instance" << id;
+    // a late write of its settings would bring the folder back
+    INISettingsObject::flushAll();
     if(!FS::deletePath(inst->instanceRoot()))
     {
         qWarning() << "Deletion of instance" << id << "has not been completely successful ...";
         return;
     }
+    // kept outside of the instance folder
+    QFile::remove(inst->consoleLogStorePath());
+    FS::deletePath(inst->cacheRoot());
 
     qDebug() << "Instance" << id << "has been deleted by the launcher.";
 }
@@ -324,11 +371,11 @@ static QMap<InstanceId, InstanceLocator> getIdMapping(const QList<InstancePtr> &
     return out;
 }
 
-QList< InstanceId > InstanceList::discoverInstances()
+QList< InstanceId > InstanceList::scanInstanceDir(const QString & instDir)
 {
-    qDebug() << "Discovering instances in" << m_instDir;
+    qDebug() << "Discovering instances in" << instDir;
     QList<InstanceId> out;
-    QDirIterator iter(m_instDir, QDir::Dirs | QDir::NoDot | QDir::NoDotDot | QDir::Readable | QDir::Hidden, QDirIterator::FollowSymlinks);
+    QDirIterator iter(instDir, QDir::Dirs | QDir::NoDot | QDir::NoDotDot | QDir::Readable | QDir::Hidden, QDirIterator::FollowSymlinks);
     while (iter.hasNext())
     {
         QString subDir = iter.next();
@@ -339,7 +386,7 @@ QList< InstanceId > InstanceList::discoverInstances()
         if(dirInfo.isSymLink())
         {
             QFileInfo targetInfo(dirInfo.symLinkTarget());
-            QFileInfo instDirInfo(m_instDir);
+            QFileInfo instDirInfo(instDir);
             if(targetInfo.canonicalPath() == instDirInfo.canonicalFilePath())
             {
                 qDebug() << "Ignoring symlink" << subDir << "that leads into the instances folder";
@@ -350,18 +397,206 @@ QList< InstanceId > InstanceList::discoverInstances()
         out.append(id);
         qDebug() << "Found instance ID" << id;
     }
-    instanceSet = out.toSet();
+    return out;
+}
+
+void InstanceList::setDiscoveredInstances(const QList<InstanceId>& ids)
+{
+    instanceSet = ids.toSet();
     m_instancesProbed = true;
+}
+
+QList< InstanceId > InstanceList::discoverInstances()
+{
+    auto out = scanInstanceDir(m_instDir);
+    setDiscoveredInstances(out);
+    return out;
+}
+
+void InstanceList::readConfigs(const QList<InstanceId>& ids, const InstanceSummaryIndex::Entries & summaries)
+{
+    for(auto & id: ids)
+    {
+        auto configPath = FS::PathCombine(m_instDir, id, "instance.cfg");
+        auto summary = summaries.value(id);
+        QtConcurrent::run(&m_loadPool, [this, id, configPath, summary]()
+        {
+            LoadedConfig loaded;
+            loaded.id = id;
+            loaded.stamp = QFileInfo(configPath).lastModified().toMSecsSinceEpoch();
+            if(summary.stamp != 0 && summary.stamp == loaded.stamp)
+            {
+                // unchanged since we last looked, the rest of it can wait
+                loaded.config = summary.values;
+                loaded.partial = true;
+            }
+            else
+            {
+                loaded.config.loadFile(configPath);
+            }
+            QMutexLocker locker(&m_loadedLock);
+            m_loadedConfigs.append(loaded);
+            if(!m_addScheduled)
+            {
+                m_addScheduled = true;
+                QMetaObject::invokeMethod(this, "addLoadedInstances", Qt::QueuedConnection);
+            }
+        });
+    }
+}
+
+QList<InstanceList::LoadedConfig> InstanceList::takeLoadedConfigs()
+{
+    QMutexLocker locker(&m_loadedLock);
+    m_addScheduled = false;
+    QList<LoadedConfig> out;
+    out.swap(m_loadedConfigs);
     return out;
 }
 
+void InstanceList::loadListAsync()
+{
+    if(m_loading)
+    {
+        return;
+    }
+    if(!m_instances.isEmpty())
+    {
+        // only the initial load is streamed, reloads need to reconcile with what's already there
+        loadList();
+        emit instancesLoaded();
+        return;
+    }
+    m_loading = true;
+    m_dirty = false;
+    m_pendingConfigs = 0;
+    m_constructionTime = 0;
+    m_loadTimer.start();
+    auto instDir = m_instDir;
+    auto indexPath = m_summaryIndexPath;
+    m_discoveryWatcher.setFuture(QtConcurrent::run(&m_loadPool, [instDir, indexPath]()
+    {
+        DiscoveryResult result;
+        if(!indexPath.isEmpty())
+        {
+            result.summaries = InstanceSummaryIndex::load(indexPath, instDir);
+        }
+        result.ids = scanInstanceDir(instDir);
+        return result;
+    }));
+}
+
+void InstanceList::discoveryFinished()
+{
+    if(!m_loading || m_discoveryDone)
+    {
+        return;
+    }
+    m_discoveryDone = true;
+    auto discovered = m_discoveryWatcher.result();
+    auto & ids = discovered.ids;
+    setDiscoveredInstances(ids);
+    m_discoveryTime = m_loadTimer.elapsed();
+
+    QElapsedTimer timer;
+    timer.start();
+    if(!m_groupsLoaded)
+    {
+        loadGroupList();
+    }
+    m_groupsTime = timer.elapsed();
+
+    m_pendingConfigs = ids.size();
+    if(ids.isEmpty())
+    {
+        finishAsyncLoad();
+        return;
+    }
+    qDebug() << "Instance summary index has" << discovered.summaries.size() << "entries for" << ids.size() << "instances";
+    readConfigs(ids, discovered.summaries);
+}
+
+void InstanceList::addLoadedInstances()
+{
+    auto loaded = takeLoadedConfigs();
+    if(loaded.isEmpty())
+    {
+        return;
+    }
+    QElapsedTimer timer;
+    timer.start();
+    QList<InstancePtr> newList;
+    for(auto & item: loaded)
+    {
+        InstancePtr instPtr = loadInstance(item);
+        if(instPtr)
+        {
+            newList.append(instPtr);
+        }
+    }
+    if(newList.size())
+    {
+        add(newList);
+    }
+    m_constructionTime += timer.elapsed();
+    if(m_loading)
+    {
+        m_pendingConfigs -= loaded.size();
+        if(m_pendingConfigs <= 0)
+        {
+            finishAsyncLoad();
+        }
+    }
+}
+
+void InstanceList::finishAsyncLoad()
+{
+    m_loading = false;
+    m_discoveryDone = false;
+    updateTotalPlayTime();
+    qDebug() << "Loaded" << m_instances.size() << "instances in" << m_loadTimer.elapsed() << "ms."
+             << "Discovery:" << m_discoveryTime << "ms,"
+             << "groups:" << m_groupsTime << "ms,"
+             << "creating instances:" << m_constructionTime << "ms,"
+             << "the rest was spent waiting for instance.cfg reads";
+    saveSummaryIndex();
+    emit instancesLoaded();
+    if(m_dirty)
+    {
+        // something changed on disk while we were loading
+        loadList();
+    }
+}
+
+void InstanceList::waitForLoad()
+{
+    if(!m_loading)
+    {
+        return;
+    }
+    m_discoveryWatcher.waitForFinished();
+    discoveryFinished();
+    m_loadPool.waitForDone();
+    addLoadedInstances();
+    if(m_loading)
+    {
+        finishAsyncLoad();
+    }
+}
+
 InstanceList::InstListError InstanceList::loadList()
 {
+    waitForLoad();
+
+    QElapsedTimer timer;
+    timer.start();
     auto existingIds = getIdMapping(m_instances);
 
-    QList<InstancePtr> newList;
+    auto ids = discoverInstances();
+    auto discoveryTime = timer.restart();
 
-    for(auto & id: discoverInstances())
+    QList<InstanceId> newIds;
+    for(auto & id: ids)
     {
         if(existingIds.contains(id))
         {
@@ -371,14 +606,36 @@ InstanceList::InstListError InstanceList::loadList()
         }
         else
         {
-            InstancePtr instPtr = loadInstance(id);
-            if(instPtr)
-            {
-                newList.append(instPtr);
-            }
+            newIds.append(id);
         }
     }
 
+    // read all the configs in parallel, then create the instances in the order they were found
+    readConfigs(newIds);
+    m_loadPool.waitForDone();
+    QMap<InstanceId, LoadedConfig> configs;
+    for(auto & loaded: takeLoadedConfigs())
+    {
+        configs.insert(loaded.id, loaded);
+    }
+    auto configTime = timer.restart();
+
+    QList<InstancePtr> newList;
+    for(auto & id: newIds)
+    {
+        auto iter = configs.constFind(id);
+        if(iter == configs.constEnd())
+        {
+            continue;
+        }
+        InstancePtr instPtr = loadInstance(*iter);
+        if(instPtr)
+        {
+            newList.append(instPtr);
+        }
+    }
+    auto constructionTime = timer.restart();
+
     // TODO: looks like a general algorithm with a few specifics inserted. Do something about it.
     if(!existingIds.isEmpty())
     {
@@ -433,6 +690,12 @@ InstanceList::InstListError InstanceList::loadList()
     }
     m_dirty = false;
     updateTotalPlayTime();
+    qDebug() << "Instance list loaded:" << newList.size() << "new instances."
+             << "Discovery:" << discoveryTime << "ms,"
+             << "reading configs:" << configTime << "ms,"
+             << "creating instances:" << constructionTime << "ms,"
+             << "updating the model:" << timer.elapsed() << "ms";
+    m_summarySaveTimer.start();
     return NoError;
 }
 
@@ -486,6 +749,11 @@ void InstanceList::suspendWatch()
 void InstanceList::providerUpdated()
 {
     m_dirty = true;
+    if(m_loading)
+    {
+        // picked up when the background load is done
+        return;
+    }
     if(m_watchLevel == 1)
     {
         loadList();
@@ -531,20 +799,26 @@ void InstanceList::propertiesChanged(BaseInstance *inst)
     {
         emit dataChanged(index(i), index(i));
         updateTotalPlayTime();
+        m_summarySaveTimer.start();
     }
 }
 
-InstancePtr InstanceList::loadInstance(const InstanceId& id)
+InstancePtr InstanceList::loadInstance(const LoadedConfig & loaded)
 {
     if(!m_groupsLoaded)
     {
         loadGroupList();
     }
 
-    auto instanceRoot = FS::PathCombine(m_instDir, id);
-    auto instanceSettings = std::make_shared<INISettingsObject>(FS::PathCombine(instanceRoot, "instance.cfg"));
+    auto instanceRoot = FS::PathCombine(m_instDir, loaded.id);
+    auto instanceSettings = std::make_shared<INISettingsObject>(FS::PathCombine(instanceRoot, "instance.cfg"), loaded.config, loaded.stamp);
+    if(loaded.partial)
+    {
+        instanceSettings->deferLoading(InstanceSummaryIndex::summaryKeys());
+    }
     InstancePtr inst;
 
+    instanceSettings->setWriteBehind(true);
     instanceSettings->registerSetting("InstanceType", "Legacy");
 
     QString inst_type = instanceSettings->get("InstanceType").toString();
@@ -19,8 +19,15 @@
 #include <QAbstractListModel>
 #include <QSet>
 #include <QList>
+#include <QMutex>
+#include <QThreadPool>
+#include <QFutureWatcher>
+#include <QElapsedTimer>
+#include <QTimer>
 
 #include "BaseInstance.h"
+#include "InstanceSummaryIndex.h"
+#include "settings/INIFile.h"
 
 #include "QObjectPtr.h"
 
@@ -91,8 +98,22 @@ public:
     }
 
     InstListError loadList();
+    /**
+     * Load the list in the background. Instances show up in the model as soon as their configuration is read,
+     * instancesLoaded() is emitted when all of them are there.
+     */
+    void loadListAsync();
+    bool isLoading() const
+    {
+        return m_loading;
+    }
+    /// Block until the background load is done
+    void waitForLoad();
     void saveNow();
 
+    /// Where to keep the summary of all instances that lets them be listed without reading every instance.cfg
+    void setSummaryIndexPath(const QString & path);
+
     InstancePtr getInstanceById(QString id) const;
     QModelIndex getInstanceIndexById(const QString &id) const;
     QStringList getGroups();
@@ -143,6 +164,7 @@ signals:
     void instancesChanged();
     void instanceSelectRequest(QString instanceId);
     void groupsChanged(QSet<QString> groups);
+    void instancesLoaded();
 
 public slots:
     void on_InstFolderChanged(const Setting &setting, QVariant value);
@@ -152,6 +174,9 @@ private slots:
     void propertiesChanged(BaseInstance *inst);
     void providerUpdated();
     void instanceDirContentsChanged(const QString &path);
+    void discoveryFinished();
+    void addLoadedInstances();
+    void saveSummaryIndex();
 
 private:
     int getInstIndex(BaseInstance *inst) const;
@@ -161,8 +186,28 @@ private:
     void add(const QList<InstancePtr> &list);
     void loadGroupList();
     void saveGroupList();
+    static QList<InstanceId> scanInstanceDir(const QString & instDir);
     QList<InstanceId> discoverInstances();
-    InstancePtr loadInstance(const InstanceId& id);
+    void setDiscoveredInstances(const QList<InstanceId> & ids);
+    void readConfigs(const QList<InstanceId> & ids, const InstanceSummaryIndex::Entries & summaries = InstanceSummaryIndex::Entries());
+    void finishAsyncLoad();
+
+    struct LoadedConfig
+    {
+        InstanceId id;
+        INIFile config;
+        qint64 stamp = 0;
+        // config only holds the summary keys, the rest is read when needed
+        bool partial = false;
+    };
+    QList<LoadedConfig> takeLoadedConfigs();
+    InstancePtr loadInstance(const LoadedConfig & loaded);
+
+    struct DiscoveryResult
+    {
+        QList<InstanceId> ids;
+        InstanceSummaryIndex::Entries summaries;
+    };
 
 private:
     int m_watchLevel = 0;
@@ -180,4 +225,23 @@ private:
     QSet<InstanceId> instanceSet;
     bool m_groupsLoaded = false;
     bool m_instancesProbed = false;
+
+    // reads instance.cfg files. They may be on slow or network storage, so this is not limited to the number of cores.
+    QThreadPool m_loadPool;
+    QMutex m_loadedLock;
+    QList<LoadedConfig> m_loadedConfigs;
+    bool m_addScheduled = false;
+
+    // state of loadListAsync
+    QFutureWatcher<DiscoveryResult> m_discoveryWatcher;
+    bool m_loading = false;
+    bool m_discoveryDone = false;
+    int m_pendingConfigs = 0;
+    QElapsedTimer m_loadTimer;
+    qint64 m_discoveryTime = 0;
+    qint64 m_groupsTime = 0;
+    qint64 m_constructionTime = 0;
+
+    QString m_summaryIndexPath;
+    QTimer m_summarySaveTimer;
 };
@@ -0,0 +1,109 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "InstanceSummaryIndex.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+#include <QDebug>
+
+#include "FileSystem.h"
+
+namespace {
+const quint32 indexMagic = 0x4D4D4949; // MMII
+// bump when summaryKeys() changes
+const quint32 indexVersion = 1;
+}
+
+namespace InstanceSummaryIndex {
+
+const QSet<QString> & summaryKeys()
+{
+    static const QSet<QString> keys = {
+        // InstanceList and the main window
+        "InstanceType", "name", "iconKey", "notes", "lastLaunchTime", "totalTimePlayed", "lastTimePlayed",
+        // read by the instance constructors
+        "IntendedVersion", "MinecraftVersion", "LWJGLVersion", "ForgeVersion", "LiteloaderVersion", "UseCustomBaseJar"
+    };
+    return keys;
+}
+
+Entries load(const QString& path, const QString& instDir)
+{
+    Entries out;
+    QFile input(path);
+    if(!input.open(QIODevice::ReadOnly))
+    {
+        return out;
+    }
+    QDataStream in(&input);
+    in.setVersion(QDataStream::Qt_5_0);
+    quint32 magic = 0, version = 0, count = 0;
+    QString indexedDir;
+    in >> magic >> version >> indexedDir >> count;
+    if(in.status() != QDataStream::Ok || magic != indexMagic || version != indexVersion || indexedDir != instDir)
+    {
+        return out;
+    }
+    for(quint32 i = 0; i < count; i++)
+    {
+        QString id;
+        Entry entry;
+        QMap<QString, QVariant> values;
+        in >> id >> entry.stamp >> values;
+        if(in.status() != QDataStream::Ok)
+        {
+            qWarning() << "Instance summary index" << path << "is damaged, ignoring it.";
+            return Entries();
+        }
+        for(auto iter = values.constBegin(); iter != values.constEnd(); iter++)
+        {
+            entry.values.insert(iter.key(), iter.value());
+        }
+        out.insert(id, entry);
+    }
+    return out;
+}
+
+bool save(const QString& path, const QString& instDir, const Entries& entries)
+{
+    if(!FS::ensureFilePathExists(path))
+    {
+        qWarning() << "Couldn't create folder for" << path;
+        return false;
+    }
+    QSaveFile output(path);
+    if(!output.open(QIODevice::WriteOnly))
+    {
+        qWarning() << "Couldn't open" << path << "for writing:" << output.errorString();
+        return false;
+    }
+    QDataStream out(&output);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << indexMagic << indexVersion << instDir << quint32(entries.size());
+    for(auto iter = entries.constBegin(); iter != entries.constEnd(); iter++)
+    {
+        out << iter.key() << iter->stamp << static_cast<const QMap<QString, QVariant> &>(iter->values);
+    }
+    if(out.status() != QDataStream::Ok || !output.commit())
+    {
+        qWarning() << "Couldn't write instance summary index" << path;
+        return false;
+    }
+    return true;
+}
+
+}
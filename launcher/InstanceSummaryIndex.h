@@ -0,0 +1,45 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QString>
+#include <QHash>
+#include <QSet>
+
+#include "settings/INIFile.h"
+
+/**
+ * What the instance list needs to know about each instance without reading its instance.cfg.
+ *
+ * For every instance, the index keeps the values of summaryKeys() together with the modification
+ * time of the instance.cfg they were taken from. An entry is only valid while that time matches.
+ */
+namespace InstanceSummaryIndex
+{
+struct Entry
+{
+    qint64 stamp = 0;
+    INIFile values;
+};
+using Entries = QHash<QString, Entry>;
+
+/// Keys of instance.cfg needed to list, sort and show instances, and to create the instance objects
+const QSet<QString> & summaryKeys();
+
+/// Read the index at path. Returns nothing if it's missing, damaged or belongs to a different instance folder.
+Entries load(const QString & path, const QString & instDir);
+bool save(const QString & path, const QString & instDir, const Entries & entries);
+}
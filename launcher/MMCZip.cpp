@@ -26,7 +26,11 @@
 bool MMCZip::mergeZipFiles(QuaZip *into, QFileInfo from, QSet<QString> &contained, const JlCompress::FilterFunction filter)
 {
     QuaZip modZip(from.filePath());
-    modZip.open(QuaZip::mdUnzip);
+    if (!modZip.open(QuaZip::mdUnzip))
+    {
+        qCritical() << "Failed to open " << from.fileName();
+        return false;
+    }
 
     QuaZipFile fileInsideMod(&modZip);
     QuaZipFile zipOutFile(into);
@@ -47,15 +51,32 @@ bool MMCZip::mergeZipFiles(QuaZip *into, QFileInfo from, QSet<QString> &containe
         }
         contained.insert(filename);
 
-        if (!fileInsideMod.open(QIODevice::ReadOnly))
+        QuaZipFileInfo64 info_in;
+        if (!modZip.getCurrentFileInfo(&info_in))
+        {
+            qCritical() << "Failed to read the header of " << filename << " from " << from.fileName();
+            return false;
+        }
+        // encrypted entries would need the password to be copied, everything else goes through as-is
+        bool raw = !(info_in.flags & 1);
+        int method = Z_DEFLATED;
+        int level = Z_DEFAULT_COMPRESSION;
+        if (!fileInsideMod.open(QIODevice::ReadOnly, &method, &level, raw))
         {
             qCritical() << "Failed to open " << filename << " from " << from.fileName();
             return false;
         }
 
         QuaZipNewInfo info_out(fileInsideMod.getActualFileName());
+        if (raw)
+        {
+            // the compressed bytes are copied unchanged, so the header has to describe them exactly
+            info_out.dateTime = info_in.dateTime;
+            info_out.uncompressedSize = info_in.uncompressedSize;
+            info_out.externalAttr = info_in.externalAttr;
+        }
 
-        if (!zipOutFile.open(QIODevice::WriteOnly, info_out))
+        if (!zipOutFile.open(QIODevice::WriteOnly, info_out, nullptr, raw ? info_in.crc : 0, method, level, raw))
         {
             qCritical() << "Failed to open " << filename << " in the jar";
             fileInsideMod.close();
@@ -70,6 +91,11 @@ bool MMCZip::mergeZipFiles(QuaZip *into, QFileInfo from, QSet<QString> &containe
         }
         zipOutFile.close();
         fileInsideMod.close();
+        if (zipOutFile.getZipError() != 0)
+        {
+            qCritical() << "Failed to write " << filename << " into the jar";
+            return false;
+        }
     }
     return true;
 }
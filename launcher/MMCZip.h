@@ -29,6 +29,8 @@ namespace MMCZip
 
     /**
      * Merge two zip files, using a filter function
+     *
+     * Entries are copied without decompressing and compressing them again.
      */
     bool mergeZipFiles(QuaZip *into, QFileInfo from, QSet<QString> &contained,
                                             const JlCompress::FilterFunction filter = nullptr);
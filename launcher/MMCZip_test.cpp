@@ -0,0 +1,228 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QDebug>
+#include "TestUtil.h"
+
+#include "MMCZip.h"
+#include <quazip.h>
+#include <quazipfile.h>
+#include <random>
+
+namespace {
+// roughly what a 1.7.10 era client jar looks like: a few thousand small, compressible class files
+const int baseEntries = 2500;
+const int modCount = 12;
+const int modEntries = 150;
+
+QByteArray fakeClass(std::mt19937 &rng, int size)
+{
+    static const char *tokens[] = {"java/lang/Object", "net/minecraft/", "Code", "LineNumberTable", "()V", "(I)I", "this", "<init>"};
+    std::uniform_int_distribution<int> pick(0, 7);
+    QByteArray data("\xCA\xFE\xBA\xBE", 4);
+    while(data.size() < size)
+    {
+        data.append(tokens[pick(rng)]);
+        data.append(char(rng() & 0xFF));
+    }
+    data.truncate(size);
+    return data;
+}
+
+bool writeZip(const QString &path, const QMap<QString, QByteArray> &entries)
+{
+    QuaZip zip(path);
+    if(!zip.open(QuaZip::mdCreate))
+    {
+        return false;
+    }
+    QuaZipFile file(&zip);
+    for(auto iter = entries.constBegin(); iter != entries.constEnd(); iter++)
+    {
+        if(!file.open(QIODevice::WriteOnly, QuaZipNewInfo(iter.key())))
+        {
+            return false;
+        }
+        file.write(iter.value());
+        file.close();
+    }
+    zip.close();
+    return zip.getZipError() == 0;
+}
+
+QMap<QString, QByteArray> readZip(const QString &path)
+{
+    QMap<QString, QByteArray> entries;
+    QuaZip zip(path);
+    if(!zip.open(QuaZip::mdUnzip))
+    {
+        return entries;
+    }
+    QuaZipFile file(&zip);
+    for(bool more = zip.goToFirstFile(); more; more = zip.goToNextFile())
+    {
+        if(!file.open(QIODevice::ReadOnly))
+        {
+            return QMap<QString, QByteArray>();
+        }
+        auto data = file.readAll();
+        file.close();
+        // closing checks the CRC
+        if(file.getZipError() != 0)
+        {
+            return QMap<QString, QByteArray>();
+        }
+        entries.insert(zip.getCurrentFileName(), data);
+    }
+    return entries;
+}
+
+// What createModdedJar used to do for zip mods: inflate and deflate every entry again
+bool referenceMerge(QuaZip *into, const QString &from, QSet<QString> &contained, bool skipMetaInf)
+{
+    QuaZip modZip(from);
+    modZip.open(QuaZip::mdUnzip);
+    QuaZipFile fileInsideMod(&modZip);
+    QuaZipFile zipOutFile(into);
+    for (bool more = modZip.goToFirstFile(); more; more = modZip.goToNextFile())
+    {
+        QString filename = modZip.getCurrentFileName();
+        if ((skipMetaInf && filename.contains("META-INF")) || contained.contains(filename))
+        {
+            continue;
+        }
+        contained.insert(filename);
+        if (!fileInsideMod.open(QIODevice::ReadOnly))
+        {
+            return false;
+        }
+        if (!zipOutFile.open(QIODevice::WriteOnly, QuaZipNewInfo(fileInsideMod.getActualFileName())))
+        {
+            fileInsideMod.close();
+            return false;
+        }
+        bool ok = JlCompress::copyData(fileInsideMod, zipOutFile);
+        zipOutFile.close();
+        fileInsideMod.close();
+        if (!ok)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool referenceModdedJar(const QString &sourceJarPath, const QString &targetJarPath, const QList<Mod> &mods)
+{
+    QuaZip zipOut(targetJarPath);
+    if (!zipOut.open(QuaZip::mdCreate))
+    {
+        return false;
+    }
+    QSet<QString> addedFiles;
+    for (int i = mods.size() - 1; i >= 0; i--)
+    {
+        if (!referenceMerge(&zipOut, mods[i].filename().absoluteFilePath(), addedFiles, false))
+        {
+            return false;
+        }
+    }
+    if (!referenceMerge(&zipOut, sourceJarPath, addedFiles, true))
+    {
+        return false;
+    }
+    zipOut.close();
+    return zipOut.getZipError() == 0;
+}
+}
+
+class MMCZipTest : public QObject
+{
+    Q_OBJECT
+
+    QTemporaryDir m_dir;
+    QString m_sourceJar;
+    QList<Mod> m_mods;
+    QMap<QString, QByteArray> m_expected;
+
+private
+slots:
+    void initTestCase()
+    {
+        QVERIFY(m_dir.isValid());
+        std::mt19937 rng(1710);
+        std::uniform_int_distribution<int> classSize(200, 12000);
+
+        QMap<QString, QByteArray> base;
+        for(int i = 0; i < baseEntries; i++)
+        {
+            base.insert(QString("%1.class").arg(i), fakeClass(rng, classSize(rng)));
+        }
+        base.insert("META-INF/MANIFEST.MF", "Manifest-Version: 1.0\n");
+        base.insert("META-INF/MOJANG_C.SF", "Signature-Version: 1.0\n");
+        m_sourceJar = m_dir.filePath("minecraft.jar");
+        QVERIFY(writeZip(m_sourceJar, base));
+        m_expected = base;
+        m_expected.remove("META-INF/MANIFEST.MF");
+        m_expected.remove("META-INF/MOJANG_C.SF");
+
+        // mods patch base classes and add their own; earlier mods win over later ones
+        QList<QMap<QString, QByteArray>> mods;
+        for(int m = 0; m < modCount; m++)
+        {
+            QMap<QString, QByteArray> mod;
+            for(int i = 0; i < modEntries; i++)
+            {
+                mod.insert(QString("%1.class").arg((m * 97 + i * 13) % baseEntries), fakeClass(rng, classSize(rng)));
+                mod.insert(QString("mod%1/%2.class").arg(m).arg(i), fakeClass(rng, classSize(rng)));
+            }
+            auto path = m_dir.filePath(QString("mod%1.zip").arg(m));
+            QVERIFY(writeZip(path, mod));
+            m_mods.append(Mod(QFileInfo(path)));
+            mods.append(mod);
+        }
+        for(int m = mods.size() - 1; m >= 0; m--)
+        {
+            for(auto iter = mods[m].constBegin(); iter != mods[m].constEnd(); iter++)
+            {
+                m_expected.insert(iter.key(), iter.value());
+            }
+        }
+    }
+
+    void test_createModdedJar()
+    {
+        auto target = m_dir.filePath("modded.jar");
+        QVERIFY(MMCZip::createModdedJar(m_sourceJar, target, m_mods));
+        auto result = readZip(target);
+        QCOMPARE(result.size(), m_expected.size());
+        QVERIFY(result == m_expected);
+    }
+
+    void test_benchmark_data()
+    {
+        QTest::addColumn<bool>("raw");
+        QTest::newRow("recompress") << false;
+        QTest::newRow("raw copy") << true;
+    }
+    void test_benchmark()
+    {
+        QFETCH(bool, raw);
+        auto target = m_dir.filePath("bench.jar");
+        QBENCHMARK
+        {
+            QFile::remove(target);
+            if(raw)
+            {
+                QVERIFY(MMCZip::createModdedJar(m_sourceJar, target, m_mods));
+            }
+            else
+            {
+                QVERIFY(referenceModdedJar(m_sourceJar, target, m_mods));
+            }
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(MMCZipTest)
+
+#include "MMCZip_test.moc"
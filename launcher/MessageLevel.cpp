@@ -25,8 +25,12 @@ MessageLevel::Enum MessageLevel::getLevel(const QString& levelName)
 MessageLevel::Enum MessageLevel::fromLine(QString &line)
 {
     // Level prefix
+    if (!line.startsWith("!!["))
+    {
+        return MessageLevel::Unknown;
+    }
     int endmark = line.indexOf("]!");
-    if (line.startsWith("!![") && endmark != -1)
+    if (endmark != -1)
     {
         auto level = MessageLevel::getLevel(line.left(endmark).mid(3));
         line = line.mid(endmark + 2);
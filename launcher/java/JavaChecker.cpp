@@ -53,6 +53,7 @@ void JavaChecker::performCheck()
     connect(&killTimer, SIGNAL(timeout()), SLOT(timeout()));
     killTimer.setSingleShot(true);
     killTimer.start(15000);
+    m_elapsed.start();
     process->start();
 }
 
@@ -87,7 +88,7 @@ void JavaChecker::finished(int exitcode, QProcess::ExitStatus status)
     result.outLog = m_stdout;
     qDebug() << "STDOUT" << m_stdout;
     qWarning() << "STDERR" << m_stderr;
-    qDebug() << "Java checker finished with status " << status << " exit code " << exitcode;
+    qDebug() << "Java checker for" << m_path << "finished with status" << status << "exit code" << exitcode << "in" << m_elapsed.elapsed() << "ms";
 
     if (status == QProcess::CrashExit || exitcode == 1)
     {
@@ -168,7 +169,7 @@ void JavaChecker::timeout()
     // NO MERCY. NO ABUSE.
     if(process)
     {
-        qDebug() << "Java checker has been killed by timeout.";
+        qDebug() << "Java checker for" << m_path << "has been killed by timeout after" << m_elapsed.elapsed() << "ms.";
         process->kill();
     }
 }
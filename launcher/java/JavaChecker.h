@@ -1,6 +1,7 @@
 #pragma once
 #include <QProcess>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <memory>
 
 #include "QObjectPtr.h"
@@ -49,6 +50,7 @@ signals:
 private:
     QProcessPtr process;
     QTimer killTimer;
+    QElapsedTimer m_elapsed;
     QString m_stdout;
     QString m_stderr;
 public
@@ -16,6 +16,26 @@
 #include "JavaCheckerJob.h"
 
 #include <QDebug>
+#include <QThread>
+
+#include <sys.h>
+
+namespace {
+// what a JVM running JavaCheck.jar takes, with some room to spare
+const uint64_t memoryPerChecker = 256 * Sys::mebibyte;
+const int maxCheckers = 8;
+
+int checkerLimit()
+{
+    int limit = qMax(1, QThread::idealThreadCount());
+    auto available = Sys::getAvailableRam();
+    if(available)
+    {
+        limit = qMin<int>(limit, available / memoryPerChecker);
+    }
+    return qBound(1, limit, maxCheckers);
+}
+}
 
 void JavaCheckerJob::partFinished(JavaCheckResult result)
 {
@@ -28,17 +48,30 @@ void JavaCheckerJob::partFinished(JavaCheckResult result)
 
     if (num_finished == javacheckers.size())
     {
+        qDebug() << m_job_name.toLocal8Bit() << "finished in" << elapsed.elapsed() << "ms";
         emitSucceeded();
+        return;
+    }
+    startCheckers();
+}
+
+void JavaCheckerJob::startCheckers()
+{
+    while (num_started < javacheckers.size() && num_started - num_finished < max_running)
+    {
+        javacheckers[num_started++]->performCheck();
     }
 }
 
 void JavaCheckerJob::executeTask()
 {
-    qDebug() << m_job_name.toLocal8Bit() << " started.";
-    for (auto iter : javacheckers)
+    max_running = checkerLimit();
+    qDebug() << m_job_name.toLocal8Bit() << "started, running up to" << max_running << "checkers at a time.";
+    elapsed.start();
+    if (javacheckers.isEmpty())
     {
-        javaresults.append(JavaCheckResult());
-        connect(iter.get(), SIGNAL(checkFinished(JavaCheckResult)), SLOT(partFinished(JavaCheckResult)));
-        iter->performCheck();
+        emitSucceeded();
+        return;
     }
+    startCheckers();
 }
@@ -33,12 +33,13 @@ public:
     bool addJavaCheckerAction(JavaCheckerPtr base)
     {
         javacheckers.append(base);
-        // if this is already running, the action needs to be started right away!
+        javaresults.append(JavaCheckResult());
+        connect(base.get(), &JavaChecker::checkFinished, this, &JavaCheckerJob::partFinished);
+        // if this is already running, the action needs to be queued up right away!
         if (isRunning())
         {
             setProgress(num_finished, javacheckers.size());
-            connect(base.get(), &JavaChecker::checkFinished, this, &JavaCheckerJob::partFinished);
-            base->performCheck();
+            startCheckers();
         }
         return true;
     }
@@ -53,9 +54,16 @@ private slots:
 protected:
     virtual void executeTask() override;
 
+private:
+    void startCheckers();
+
 private:
     QString m_job_name;
     QList<JavaCheckerPtr> javacheckers;
     QList<JavaCheckResult> javaresults;
     int num_finished = 0;
+    int num_started = 0;
+    // every checker is a JVM, starting all of them at once makes them slow enough to hit the timeout
+    int max_running = 1;
+    QElapsedTimer elapsed;
 };
@@ -22,8 +22,12 @@
 #include "java/JavaInstallList.h"
 #include "java/JavaCheckerJob.h"
 #include "java/JavaUtils.h"
+#include "java/JavaProbeCache.h"
 #include "MMCStrings.h"
 #include "minecraft/VersionFilterData.h"
+#include "net/HttpMetaCache.h"
+#include "FileSystem.h"
+#include "Application.h"
 
 JavaInstallList::JavaInstallList(QObject *parent) : BaseVersionList(parent)
 {
@@ -149,34 +153,58 @@ void JavaListLoadTask::executeTask()
     JavaUtils ju;
     QList<QString> candidate_paths = ju.FindJavaPaths();
 
+    m_probeCache.reset(new JavaProbeCache(FS::PathCombine(APPLICATION->metacache()->getBasePath("general"), "javaprobes.dat")));
+    m_results.clear();
+    m_probedCandidates.clear();
+
     m_job = new JavaCheckerJob("Java detection");
     connect(m_job.get(), &Task::finished, this, &JavaListLoadTask::javaCheckerFinished);
     connect(m_job.get(), &Task::progress, this, &Task::setProgress);
 
     qDebug() << "Probing the following Java paths: ";
-    int id = 0;
     for(QString candidate : candidate_paths)
     {
+        JavaCheckResult result;
+        if(m_probeCache->lookup(candidate, result))
+        {
+            qDebug() << " " << candidate << "(unchanged since last time)";
+            m_results.append(result);
+            continue;
+        }
         qDebug() << " " << candidate;
+        m_results.append(JavaCheckResult());
 
         auto candidate_checker = new JavaChecker();
         candidate_checker->m_path = candidate;
-        candidate_checker->m_id = id;
+        candidate_checker->m_id = m_probedCandidates.size();
         m_job->addJavaCheckerAction(JavaCheckerPtr(candidate_checker));
-
-        id++;
+        m_probedCandidates.append(m_results.size() - 1);
     }
+    qDebug() << "Reusing" << m_results.size() - m_probedCandidates.size() << "earlier results, running" << m_probedCandidates.size() << "java checkers.";
 
+    if(m_probedCandidates.isEmpty())
+    {
+        // the job would never finish without anything to do. Finish later, so whoever started this can connect to it first.
+        QMetaObject::invokeMethod(this, "javaCheckerFinished", Qt::QueuedConnection);
+        return;
+    }
     m_job->start();
 }
 
 void JavaListLoadTask::javaCheckerFinished()
 {
-    QList<JavaInstallPtr> candidates;
-    auto results = m_job->getResults();
+    auto probed = m_job->getResults();
+    for(int i = 0; i < probed.size() && i < m_probedCandidates.size(); i++)
+    {
+        m_results[m_probedCandidates[i]] = probed[i];
+        m_probeCache->insert(probed[i]);
+    }
+    m_probeCache->forgetUnused();
+    m_probeCache->save();
 
+    QList<JavaInstallPtr> candidates;
     qDebug() << "Found the following valid Java installations:";
-    for(JavaCheckResult result : results)
+    for(JavaCheckResult result : m_results)
     {
         if(result.validity == JavaCheckResult::Validity::Valid)
         {
@@ -17,6 +17,7 @@
 
 #include <QObject>
 #include <QAbstractListModel>
+#include <memory>
 
 #include "BaseVersionList.h"
 #include "tasks/Task.h"
@@ -27,6 +28,7 @@
 #include "QObjectPtr.h"
 
 class JavaListLoadTask;
+class JavaProbeCache;
 
 class JavaInstallList : public BaseVersionList
 {
@@ -76,6 +78,11 @@ public slots:
 
 protected:
     shared_qobject_ptr<JavaCheckerJob> m_job;
+    std::unique_ptr<JavaProbeCache> m_probeCache;
+    // one result per candidate, in the order they were found
+    QVector<JavaCheckResult> m_results;
+    // candidate index of each java checker in m_job
+    QVector<int> m_probedCandidates;
     JavaInstallList *m_list;
     JavaInstall *m_currentRecommended;
 };
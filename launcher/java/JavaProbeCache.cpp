@@ -0,0 +1,205 @@
+#include "JavaProbeCache.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QDebug>
+
+#include "FileSystem.h"
+
+namespace {
+const quint32 cacheMagic = 0x4D4D4A50; // MMJP
+// bump when JavaCheck.jar or the way its output is interpreted changes
+const quint32 cacheVersion = 1;
+}
+
+bool JavaProbeCache::Stamp::operator==(const Stamp& other) const
+{
+    return size == other.size && lastModified == other.lastModified && releasePath == other.releasePath
+        && releaseSize == other.releaseSize && releaseModified == other.releaseModified;
+}
+
+JavaProbeCache::JavaProbeCache(const QString& path) : m_path(path)
+{
+}
+
+bool JavaProbeCache::identify(const QString& javaPath, QString& key, Stamp& stamp)
+{
+    QFileInfo binary(javaPath);
+    // the default java is just a name, found on the PATH
+    if(!binary.exists() && !javaPath.contains('/') && !javaPath.contains('\\'))
+    {
+        auto found = QStandardPaths::findExecutable(javaPath);
+        if(found.isEmpty())
+        {
+            return false;
+        }
+        binary.setFile(found);
+    }
+    key = binary.canonicalFilePath();
+    if(key.isEmpty())
+    {
+        return false;
+    }
+    binary.setFile(key);
+    stamp.size = binary.size();
+    stamp.lastModified = binary.lastModified().toMSecsSinceEpoch();
+
+    // updating a JRE in place may leave the binary alone, but not the release file next to bin/
+    QFileInfo release(FS::PathCombine(binary.absolutePath(), "..", "release"));
+    stamp.releasePath = release.canonicalFilePath();
+    if(!stamp.releasePath.isEmpty())
+    {
+        stamp.releaseSize = release.size();
+        stamp.releaseModified = release.lastModified().toMSecsSinceEpoch();
+    }
+    return true;
+}
+
+bool JavaProbeCache::lookup(const QString& javaPath, JavaCheckResult& result)
+{
+    load();
+    QString key;
+    Stamp stamp;
+    if(!identify(javaPath, key, stamp))
+    {
+        return false;
+    }
+    m_used.insert(key);
+    auto iter = m_entries.constFind(key);
+    if(iter == m_entries.constEnd() || !(iter->stamp == stamp))
+    {
+        return false;
+    }
+    result = JavaCheckResult();
+    result.path = javaPath;
+    result.validity = iter->validity;
+    result.mojangPlatform = iter->mojangPlatform;
+    result.realPlatform = iter->realPlatform;
+    result.javaVersion = iter->javaVersion;
+    result.javaVendor = iter->javaVendor;
+    result.is_64bit = iter->is_64bit;
+    return true;
+}
+
+void JavaProbeCache::insert(const JavaCheckResult& result)
+{
+    if(result.validity == JavaCheckResult::Validity::Errored)
+    {
+        return;
+    }
+    load();
+    QString key;
+    Entry entry;
+    if(!identify(result.path, key, entry.stamp))
+    {
+        return;
+    }
+    auto javaVersion = result.javaVersion;
+    entry.validity = result.validity;
+    entry.mojangPlatform = result.mojangPlatform;
+    entry.realPlatform = result.realPlatform;
+    entry.javaVersion = javaVersion.toString();
+    entry.javaVendor = result.javaVendor;
+    entry.is_64bit = result.is_64bit;
+    m_entries.insert(key, entry);
+    m_used.insert(key);
+    m_dirty = true;
+}
+
+void JavaProbeCache::forgetUnused()
+{
+    load();
+    auto iter = m_entries.begin();
+    while(iter != m_entries.end())
+    {
+        if(!m_used.contains(iter.key()))
+        {
+            iter = m_entries.erase(iter);
+            m_dirty = true;
+        }
+        else
+        {
+            iter++;
+        }
+    }
+}
+
+void JavaProbeCache::load()
+{
+    if(m_loaded)
+    {
+        return;
+    }
+    m_loaded = true;
+
+    QFile input(m_path);
+    if(!input.open(QIODevice::ReadOnly))
+    {
+        return;
+    }
+    QDataStream in(&input);
+    in.setVersion(QDataStream::Qt_5_0);
+    quint32 magic = 0, version = 0, count = 0;
+    in >> magic >> version >> count;
+    if(in.status() != QDataStream::Ok || magic != cacheMagic || version != cacheVersion)
+    {
+        return;
+    }
+    for(quint32 i = 0; i < count; i++)
+    {
+        QString key;
+        Entry entry;
+        qint32 validity = 0;
+        in >> key >> entry.stamp.size >> entry.stamp.lastModified >> entry.stamp.releasePath >> entry.stamp.releaseSize
+           >> entry.stamp.releaseModified >> validity >> entry.mojangPlatform >> entry.realPlatform >> entry.javaVersion
+           >> entry.javaVendor >> entry.is_64bit;
+        if(in.status() != QDataStream::Ok || validity < 0 || validity > qint32(JavaCheckResult::Validity::Valid))
+        {
+            qWarning() << "Java probe cache" << m_path << "is damaged, ignoring the rest of it.";
+            m_dirty = true;
+            break;
+        }
+        entry.validity = JavaCheckResult::Validity(validity);
+        m_entries.insert(key, entry);
+    }
+}
+
+void JavaProbeCache::save()
+{
+    if(!m_dirty)
+    {
+        return;
+    }
+    if(!FS::ensureFilePathExists(m_path))
+    {
+        qWarning() << "Couldn't create folder for" << m_path;
+        return;
+    }
+    QSaveFile output(m_path);
+    if(!output.open(QIODevice::WriteOnly))
+    {
+        qWarning() << "Couldn't open" << m_path << "for writing:" << output.errorString();
+        return;
+    }
+    QDataStream out(&output);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << cacheMagic << cacheVersion << quint32(m_entries.size());
+    for(auto iter = m_entries.constBegin(); iter != m_entries.constEnd(); iter++)
+    {
+        auto & entry = iter.value();
+        out << iter.key() << entry.stamp.size << entry.stamp.lastModified << entry.stamp.releasePath << entry.stamp.releaseSize
+            << entry.stamp.releaseModified << qint32(entry.validity) << entry.mojangPlatform << entry.realPlatform << entry.javaVersion
+            << entry.javaVendor << entry.is_64bit;
+    }
+    if(out.status() != QDataStream::Ok || !output.commit())
+    {
+        qWarning() << "Couldn't write java probe cache" << m_path;
+        return;
+    }
+    m_dirty = false;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <QString>
+#include <QHash>
+#include <QSet>
+
+#include "JavaChecker.h"
+
+/**
+ * Remembers what the java checker found out about java installations, so unchanged ones don't need a JVM started again.
+ *
+ * Entries are keyed by the resolved path of the java binary. They are only used while the binary and the release file
+ * of its installation keep their size and modification time. Failed checks are not remembered, they might not fail
+ * next time.
+ */
+class JavaProbeCache
+{
+public:
+    explicit JavaProbeCache(const QString & path);
+
+    /// Returns true if the java binary at javaPath was checked before and didn't change since.
+    bool lookup(const QString & javaPath, JavaCheckResult & result);
+    void insert(const JavaCheckResult & result);
+
+    /// Forget all installations that weren't looked up or inserted since the cache was loaded
+    void forgetUnused();
+
+    void save();
+
+private:
+    struct Stamp
+    {
+        qint64 size = 0;
+        qint64 lastModified = 0;
+        QString releasePath;
+        qint64 releaseSize = 0;
+        qint64 releaseModified = 0;
+
+        bool operator==(const Stamp & other) const;
+    };
+    struct Entry
+    {
+        Stamp stamp;
+        JavaCheckResult::Validity validity = JavaCheckResult::Validity::Errored;
+        QString mojangPlatform;
+        QString realPlatform;
+        QString javaVersion;
+        QString javaVendor;
+        bool is_64bit = false;
+    };
+
+    void load();
+    static bool identify(const QString & javaPath, QString & key, Stamp & stamp);
+
+private:
+    QString m_path;
+    bool m_loaded = false;
+    bool m_dirty = false;
+    QHash<QString, Entry> m_entries;
+    QSet<QString> m_used;
+};
@@ -127,18 +127,12 @@ void LaunchTask::onProgressReportingRequested()
 
 void LaunchTask::setCensorFilter(QMap<QString, QString> filter)
 {
-    m_censorFilter = filter;
+    m_censor.setFilter(filter);
 }
 
 QString LaunchTask::censorPrivateInfo(QString in)
 {
-    auto iter = m_censorFilter.begin();
-    while (iter != m_censorFilter.end())
-    {
-        in.replace(iter.key(), iter.value());
-        iter++;
-    }
-    return in;
+    return m_censor.apply(in);
 }
 
 void LaunchTask::proceed()
@@ -215,6 +209,10 @@ shared_qobject_ptr<LogModel> LaunchTask::getLogModel()
         m_logModel->setOverflowMessage(tr("MultiMC stopped watching the game log because the log length surpassed %1 lines.\n"
             "You may have to fix your mods because the game is still logging to files and"
             " likely wasting harddrive space at an alarming rate!").arg(m_logModel->getMaxLines()));
+        if(m_instance->shouldLogConsoleToDisk())
+        {
+            m_logModel->setStorePath(m_instance->consoleLogStorePath());
+        }
     }
     return m_logModel;
 }
@@ -23,6 +23,7 @@
 #include "MessageLevel.h"
 #include "LoggedProcess.h"
 #include "LaunchStep.h"
+#include "LogCensor.h"
 
 class LaunchTask: public Task
 {
@@ -116,7 +117,7 @@ protected: /* data */
     InstancePtr m_instance;
     shared_qobject_ptr<LogModel> m_logModel;
     QList <shared_qobject_ptr<LaunchStep>> m_steps;
-    QMap<QString, QString> m_censorFilter;
+    LogCensor m_censor;
     int currentStep = -1;
     State state = NotStarted;
     qint64 m_pid = -1;
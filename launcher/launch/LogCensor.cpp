@@ -0,0 +1,44 @@
+#include "LogCensor.h"
+
+void LogCensor::setFilter(const QMap<QString, QString>& filter)
+{
+    m_patterns.clear();
+    for(auto iter = filter.constBegin(); iter != filter.constEnd(); iter++)
+    {
+        if(iter.key().isEmpty())
+        {
+            continue;
+        }
+        Pattern pattern;
+        pattern.matcher.setPattern(iter.key());
+        pattern.replacement = iter.value();
+        m_patterns.append(pattern);
+    }
+}
+
+QString LogCensor::apply(const QString& in) const
+{
+    QString out = in;
+    for(auto & pattern: m_patterns)
+    {
+        int index = pattern.matcher.indexIn(out);
+        if(index < 0)
+        {
+            continue;
+        }
+        const int length = pattern.matcher.pattern().size();
+        QString replaced;
+        replaced.reserve(out.size());
+        int from = 0;
+        while(index >= 0)
+        {
+            replaced.append(out.midRef(from, index - from));
+            replaced.append(pattern.replacement);
+            from = index + length;
+            index = pattern.matcher.indexIn(out, from);
+        }
+        replaced.append(out.midRef(from));
+        out = replaced;
+    }
+    return out;
+}
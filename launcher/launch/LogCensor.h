@@ -0,0 +1,34 @@
+#pragma once
+
+#include <QString>
+#include <QStringMatcher>
+#include <QMap>
+#include <QVector>
+
+/**
+ * Replaces secrets (tokens, session IDs, ...) in log lines.
+ *
+ * The secrets are long literals, so each gets a precompiled Boyer-Moore matcher that skips through
+ * the line in steps of the secret's length. Lines that contain none of them are returned untouched,
+ * without being copied.
+ */
+class LogCensor
+{
+public:
+    void setFilter(const QMap<QString, QString> & filter);
+
+    bool isEmpty() const
+    {
+        return m_patterns.isEmpty();
+    }
+
+    QString apply(const QString & in) const;
+
+private:
+    struct Pattern
+    {
+        QStringMatcher matcher;
+        QString replacement;
+    };
+    QVector<Pattern> m_patterns;
+};
@@ -1,8 +1,55 @@
 #include "LogModel.h"
+#include "LogStore.h"
+
+namespace {
+// about one frame
+const int visibleFlushInterval = 16;
+const int hiddenFlushInterval = 1000;
+// a game spamming its log shouldn't be able to fill up the disk
+const qint64 maxStoreSize = 256 * 1024 * 1024;
+}
 
 LogModel::LogModel(QObject *parent):QAbstractListModel(parent)
 {
     m_content.resize(m_maxLines);
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(hiddenFlushInterval);
+    connect(&m_flushTimer, &QTimer::timeout, this, &LogModel::flushPending);
+}
+
+LogModel::~LogModel()
+{
+}
+
+bool LogModel::setStorePath(const QString& path)
+{
+    flush();
+    std::unique_ptr<LogStore> store(new LogStore(path));
+    if(!store->open())
+    {
+        return false;
+    }
+    beginResetModel();
+    // carry over what's already in memory
+    for(int i = 0; i < m_numLines; i++)
+    {
+        auto & item = m_content[(m_firstLine + i) % m_maxLines];
+        store->append(item.level, item.line);
+    }
+    m_store = std::move(store);
+    m_storeRows = m_store->lineCount();
+    m_storeFull = false;
+    m_firstLine = 0;
+    m_numLines = 0;
+    m_content.clear();
+    m_content.squeeze();
+    endResetModel();
+    return true;
+}
+
+bool LogModel::isStoreBacked() const
+{
+    return m_store != nullptr;
 }
 
 int LogModel::rowCount(const QModelIndex &parent) const
@@ -10,11 +57,28 @@ int LogModel::rowCount(const QModelIndex &parent) const
     if (parent.isValid())
         return 0;
 
+    if(m_store)
+        return m_storeRows;
     return m_numLines;
 }
 
 QVariant LogModel::data(const QModelIndex &index, int role) const
 {
+    if(m_store)
+    {
+        if (index.row() < 0 || index.row() >= m_storeRows)
+            return QVariant();
+        if (role != Qt::DisplayRole && role != Qt::EditRole && role != LevelRole)
+            return QVariant();
+        MessageLevel::Enum level;
+        QString line;
+        if(!m_store->line(index.row(), level, line))
+            return QVariant();
+        if(role == LevelRole)
+            return level;
+        return line;
+    }
+
     if (index.row() < 0 || index.row() >= m_numLines)
         return QVariant();
 
@@ -34,39 +98,151 @@ QVariant LogModel::data(const QModelIndex &index, int role) const
 
 void LogModel::append(MessageLevel::Enum level, QString line)
 {
+    if(m_store)
+    {
+        if(m_storeFull)
+        {
+            return;
+        }
+        // everything is kept, even while the views are suspended
+        m_pending.append(entry{level, line});
+        if(!m_flushTimer.isActive())
+        {
+            m_flushTimer.start();
+        }
+        return;
+    }
     if(m_suspended)
     {
         return;
     }
-    int lineNum = (m_firstLine + m_numLines) % m_maxLines;
-    // overflow
-    if(m_numLines == m_maxLines)
+    // anything beyond what the buffer can hold would be thrown out by the flush anyway
+    if(m_pending.size() >= m_maxLines)
     {
         if(m_stopOnOverflow)
+        {
+            return;
+        }
+        // trim in bulk, not on every line
+        if(m_pending.size() >= m_maxLines * 2)
+        {
+            m_pending.remove(0, m_pending.size() - m_maxLines);
+        }
+    }
+    m_pending.append(entry{level, line});
+    if(!m_flushTimer.isActive())
+    {
+        m_flushTimer.start();
+    }
+}
+
+void LogModel::flushPending()
+{
+    flush();
+}
+
+void LogModel::flush()
+{
+    m_flushTimer.stop();
+    if(m_store)
+    {
+        for(auto & item: m_pending)
+        {
+            if(m_store->failed())
+            {
+                // the lines it can't write would pile up in memory
+                m_store->append(MessageLevel::Fatal, tr("The game log couldn't be written to disk, the rest of it was not recorded."));
+                m_storeFull = true;
+                break;
+            }
+            if(m_store->size() >= maxStoreSize)
+            {
+                m_store->append(MessageLevel::Fatal, tr("The game log got too large to keep, the rest of it was not recorded."));
+                m_storeFull = true;
+                break;
+            }
+            m_store->append(item.level, item.line);
+        }
+        m_pending.clear();
+        int total = m_store->lineCount();
+        if(m_suspended || total == m_storeRows)
+        {
+            return;
+        }
+        beginInsertRows(QModelIndex(), m_storeRows, total - 1);
+        m_storeRows = total;
+        endInsertRows();
+        return;
+    }
+    if(m_pending.isEmpty())
+    {
+        return;
+    }
+    QVector<entry> pending;
+    pending.swap(m_pending);
+
+    int count = pending.size();
+    if(m_stopOnOverflow)
+    {
+        int space = m_maxLines - m_numLines;
+        if(space <= 0)
         {
             // nothing more to do, the buffer is full
             return;
         }
-        beginRemoveRows(QModelIndex(), 0, 0);
-        m_firstLine = (m_firstLine + 1) % m_maxLines;
-        m_numLines --;
+        if(count >= space)
+        {
+            // the last free line gets the overflow message
+            count = space;
+            pending[count - 1] = entry{MessageLevel::Fatal, m_overflowMessage};
+        }
+    }
+    // only the newest lines survive
+    int skip = qMax(0, count - m_maxLines);
+    count -= skip;
+
+    int overflow = m_numLines + count - m_maxLines;
+    if(overflow > 0)
+    {
+        beginRemoveRows(QModelIndex(), 0, overflow - 1);
+        m_firstLine = (m_firstLine + overflow) % m_maxLines;
+        m_numLines -= overflow;
         endRemoveRows();
     }
-    else if (m_numLines == m_maxLines - 1 && m_stopOnOverflow)
+    beginInsertRows(QModelIndex(), m_numLines, m_numLines + count - 1);
+    for(int i = 0; i < count; i++)
     {
-        level = MessageLevel::Fatal;
-        line = m_overflowMessage;
+        int lineNum = (m_firstLine + m_numLines) % m_maxLines;
+        m_content[lineNum] = pending[skip + i];
+        m_numLines ++;
     }
-    beginInsertRows(QModelIndex(), m_numLines, m_numLines);
-    m_numLines ++;
-    m_content[lineNum].level = level;
-    m_content[lineNum].line = line;
     endInsertRows();
 }
 
+void LogModel::addVisibleView()
+{
+    m_visibleViews++;
+    m_flushTimer.setInterval(visibleFlushInterval);
+    // catch up right away
+    flush();
+}
+
+void LogModel::removeVisibleView()
+{
+    if(m_visibleViews > 0 && --m_visibleViews == 0)
+    {
+        m_flushTimer.setInterval(hiddenFlushInterval);
+    }
+}
+
 void LogModel::suspend(bool suspend)
 {
     m_suspended = suspend;
+    if(!m_suspended && m_store)
+    {
+        // show what was recorded in the meantime
+        flush();
+    }
 }
 
 bool LogModel::suspended()
@@ -76,14 +252,27 @@ bool LogModel::suspended()
 
 void LogModel::clear()
 {
+    m_pending.clear();
+    m_flushTimer.stop();
     beginResetModel();
     m_firstLine = 0;
     m_numLines = 0;
+    if(m_store)
+    {
+        m_store->clear();
+        m_storeRows = 0;
+        m_storeFull = false;
+    }
     endResetModel();
 }
 
 QString LogModel::toPlainText()
 {
+    flush();
+    if(m_store)
+    {
+        return m_store->toPlainText();
+    }
     QString out;
     out.reserve(m_numLines * 80);
     for(int i = 0; i < m_numLines; i++)
@@ -97,11 +286,18 @@ QString LogModel::toPlainText()
 
 void LogModel::setMaxLines(int maxLines)
 {
+    flush();
     // no-op
     if(maxLines == m_maxLines)
     {
         return;
     }
+    if(m_store)
+    {
+        // only used by views now
+        m_maxLines = maxLines;
+        return;
+    }
     // if it all still fits in the buffer, just resize it
     if(m_firstLine + m_numLines < m_maxLines)
     {
@@ -2,25 +2,45 @@
 
 #include <QAbstractListModel>
 #include <QString>
+#include <QTimer>
+#include <memory>
 #include "MessageLevel.h"
 
+class LogStore;
+
 class LogModel : public QAbstractListModel
 {
     Q_OBJECT
 public:
     explicit LogModel(QObject *parent = 0);
+    virtual ~LogModel();
 
     int rowCount(const QModelIndex &parent = QModelIndex()) const;
     QVariant data(const QModelIndex &index, int role) const;
 
+    /// Queue a line. Queued lines are added to the model together, see flush()
     void append(MessageLevel::Enum, QString line);
+    /// Add all queued lines to the model, with at most one row removal and one row insertion
+    void flush();
     void clear();
 
+    /// Views showing the model count themselves in while they are visible, lines are added less often while nobody is looking
+    void addVisibleView();
+    void removeVisibleView();
+
     void suspend(bool suspend);
     bool suspended();
 
     QString toPlainText();
 
+    /**
+     * Keep the whole log in a compressed file at path instead of the in-memory buffer. Returns false if the file can't be used.
+     * The line limit and stop on overflow don't apply to the store, it only stops when the file gets too large or can't be
+     * written to anymore.
+     */
+    bool setStorePath(const QString & path);
+    bool isStoreBacked() const;
+
     int getMaxLines();
     void setMaxLines(int maxLines);
     void setStopOnOverflow(bool stop);
@@ -41,8 +61,15 @@ private /* types */:
         QString line;
     };
 
+private slots:
+    void flushPending();
+
 private: /* data */
     QVector <entry> m_content;
+    // lines waiting for the next flush
+    QVector <entry> m_pending;
+    QTimer m_flushTimer;
+    int m_visibleViews = 0;
     int m_maxLines = 1000;
     // first line in the circular buffer
     int m_firstLine = 0;
@@ -52,6 +79,11 @@ private: /* data */
     QString m_overflowMessage = "OVERFLOW";
     bool m_suspended = false;
     bool m_lineWrap = true;
+    std::unique_ptr<LogStore> m_store;
+    // lines in the store the views were told about. More can be in the store while suspended.
+    int m_storeRows = 0;
+    // the store hit its limit and ends with the overflow message
+    bool m_storeFull = false;
 
 private:
     Q_DISABLE_COPY(LogModel)
@@ -0,0 +1,173 @@
+#include "LogStore.h"
+
+#include <QDataStream>
+#include <QDebug>
+
+#include "FileSystem.h"
+
+namespace {
+const int linesPerBlock = 512;
+// decompressed blocks kept around for scrolling and searching
+const int cachedBlocks = 8;
+}
+
+LogStore::LogStore(const QString& path) : m_file(path), m_cache(cachedBlocks)
+{
+}
+
+bool LogStore::open()
+{
+    if(!FS::ensureFilePathExists(m_file.fileName()))
+    {
+        qWarning() << "Couldn't create folder for" << m_file.fileName();
+        m_failed = true;
+        return false;
+    }
+    if(!m_file.open(QIODevice::ReadWrite | QIODevice::Truncate))
+    {
+        qWarning() << "Couldn't open log store" << m_file.fileName() << ":" << m_file.errorString();
+        m_failed = true;
+        return false;
+    }
+    return true;
+}
+
+void LogStore::clear()
+{
+    m_blockOffsets.clear();
+    m_sealedLines = 0;
+    m_openBlock.clear();
+    m_cache.clear();
+    if(m_file.isOpen())
+    {
+        m_file.resize(0);
+    }
+}
+
+void LogStore::append(MessageLevel::Enum level, const QString& line)
+{
+    m_openBlock.append(Line{level, line});
+    if(m_openBlock.size() >= linesPerBlock)
+    {
+        sealBlock();
+    }
+}
+
+void LogStore::sealBlock()
+{
+    if(m_failed || !m_file.isOpen())
+    {
+        // keep the lines in memory, better than losing them. Callers should stop appending, see failed().
+        return;
+    }
+    QByteArray data;
+    {
+        QDataStream out(&data, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_5_0);
+        out << quint32(m_openBlock.size());
+        for(auto & line: m_openBlock)
+        {
+            out << quint8(line.level) << line.text;
+        }
+    }
+    QByteArray compressed = qCompress(data);
+    qint64 offset = m_file.size();
+    QDataStream out(&m_file);
+    out.setVersion(QDataStream::Qt_5_0);
+    if(!m_file.seek(offset))
+    {
+        m_failed = true;
+        return;
+    }
+    out << quint32(compressed.size());
+    if(out.status() != QDataStream::Ok || m_file.write(compressed) != compressed.size())
+    {
+        qWarning() << "Couldn't write to log store" << m_file.fileName() << ":" << m_file.errorString();
+        m_failed = true;
+        return;
+    }
+    m_file.flush();
+    m_blockOffsets.append(offset);
+    m_sealedLines += m_openBlock.size();
+    m_cache.insert(m_blockOffsets.size() - 1, new Block(m_openBlock));
+    m_openBlock.clear();
+}
+
+const LogStore::Block * LogStore::block(int index)
+{
+    if(auto cached = m_cache.object(index))
+    {
+        return cached;
+    }
+    if(!m_file.seek(m_blockOffsets[index]))
+    {
+        return nullptr;
+    }
+    QDataStream in(&m_file);
+    in.setVersion(QDataStream::Qt_5_0);
+    quint32 size = 0;
+    in >> size;
+    QByteArray data = qUncompress(m_file.read(size));
+    if(in.status() != QDataStream::Ok || data.isEmpty())
+    {
+        qWarning() << "Log store" << m_file.fileName() << "has a damaged block at" << m_blockOffsets[index];
+        return nullptr;
+    }
+    QDataStream blockIn(data);
+    blockIn.setVersion(QDataStream::Qt_5_0);
+    quint32 count = 0;
+    blockIn >> count;
+    auto result = new Block();
+    result->reserve(count);
+    for(quint32 i = 0; i < count; i++)
+    {
+        quint8 level = 0;
+        QString text;
+        blockIn >> level >> text;
+        result->append(Line{MessageLevel::Enum(level), text});
+    }
+    m_cache.insert(index, result);
+    return result;
+}
+
+bool LogStore::line(int index, MessageLevel::Enum& level, QString& text)
+{
+    if(index < 0 || index >= lineCount())
+    {
+        return false;
+    }
+    if(index >= m_sealedLines)
+    {
+        auto & line = m_openBlock[index - m_sealedLines];
+        level = line.level;
+        text = line.text;
+        return true;
+    }
+    // all sealed blocks are full
+    auto lines = block(index / linesPerBlock);
+    int offset = index % linesPerBlock;
+    if(!lines || offset >= lines->size())
+    {
+        return false;
+    }
+    level = lines->at(offset).level;
+    text = lines->at(offset).text;
+    return true;
+}
+
+QString LogStore::toPlainText()
+{
+    QString out;
+    MessageLevel::Enum level;
+    QString text;
+    int count = lineCount();
+    for(int i = 0; i < count; i++)
+    {
+        if(line(i, level, text))
+        {
+            out.append(text);
+        }
+        out.append('\n');
+    }
+    return out;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <QString>
+#include <QFile>
+#include <QVector>
+#include <QCache>
+
+#include "MessageLevel.h"
+
+/**
+ * Append-only storage for a whole game log, on disk.
+ *
+ * Lines are collected into blocks of a fixed number of lines. Full blocks are compressed and appended to the
+ * segment file, and only the file offset of each block is kept in memory. Reading a line decompresses its block,
+ * the last few blocks read are cached.
+ *
+ * Each block is stored as a quint32 size followed by the qCompress-ed QDataStream of its lines.
+ */
+class LogStore
+{
+public:
+    explicit LogStore(const QString & path);
+
+    /// Create or truncate the segment file
+    bool open();
+    void clear();
+
+    void append(MessageLevel::Enum level, const QString & line);
+
+    int lineCount() const
+    {
+        return m_sealedLines + m_openBlock.size();
+    }
+
+    /// Read back a line. Returns false if it can't be read.
+    bool line(int index, MessageLevel::Enum & level, QString & text);
+
+    QString toPlainText();
+
+    QString path() const
+    {
+        return m_file.fileName();
+    }
+
+    /// true once the segment file couldn't be written. Appended lines then stay in memory.
+    bool failed() const
+    {
+        return m_failed;
+    }
+
+    /// bytes in the segment file, not counting the lines that aren't sealed into a block yet
+    qint64 size() const
+    {
+        return m_file.size();
+    }
+
+private:
+    struct Line
+    {
+        MessageLevel::Enum level;
+        QString text;
+    };
+    typedef QVector<Line> Block;
+
+    void sealBlock();
+    const Block * block(int index);
+
+private:
+    QFile m_file;
+    bool m_failed = false;
+    // where each sealed block starts in the file
+    QVector<qint64> m_blockOffsets;
+    int m_sealedLines = 0;
+    Block m_openBlock;
+    QCache<int, Block> m_cache;
+};
@@ -0,0 +1,54 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include "TestUtil.h"
+
+#include "launch/LogStore.h"
+
+class LogStoreTest : public QObject
+{
+    Q_OBJECT
+private
+slots:
+    void test_roundTrip()
+    {
+        QTemporaryDir dir;
+        LogStore store(dir.filePath("console.mmclog"));
+        QVERIFY(store.open());
+        // several full blocks and a partial one
+        const int count = 2000;
+        for(int i = 0; i < count; i++)
+        {
+            store.append(i % 7 == 0 ? MessageLevel::Error : MessageLevel::Message, QString("line %1").arg(i));
+        }
+        QCOMPARE(store.lineCount(), count);
+
+        // read in an order that defeats the block cache
+        for(int i = 0; i < count; i += 97)
+        {
+            int index = (i * 31) % count;
+            MessageLevel::Enum level;
+            QString text;
+            QVERIFY(store.line(index, level, text));
+            QCOMPARE(text, QString("line %1").arg(index));
+            QCOMPARE(level, index % 7 == 0 ? MessageLevel::Error : MessageLevel::Message);
+        }
+
+        auto lines = store.toPlainText().split('\n');
+        QCOMPARE(lines.size(), count + 1);
+        QCOMPARE(lines[1234], QString("line 1234"));
+
+        MessageLevel::Enum level;
+        QString text;
+        QVERIFY(!store.line(count, level, text));
+
+        store.clear();
+        QCOMPARE(store.lineCount(), 0);
+        store.append(MessageLevel::Warning, "again");
+        QVERIFY(store.line(0, level, text));
+        QCOMPARE(text, QString("again"));
+    }
+};
+
+QTEST_GUILESS_MAIN(LogStoreTest)
+
+#include "LogStore_test.moc"
@@ -32,6 +32,11 @@ public:
     void executeTask() override;
     bool canAbort() const override;
     void proceed() override;
+    /// Run this instead of the instance's update task. Only before this step runs.
+    void setUpdateTask(Task::Ptr task)
+    {
+        m_updateTask = task;
+    }
 public slots:
     bool abort() override;
 
@@ -78,6 +78,12 @@ QUrl Meta::BaseEntity::url() const
     return QUrl(BuildConfig.META_URL).resolved(localFilename());
 }
 
+qint64 Meta::BaseEntity::maxAge() const
+{
+    // indexes change whenever something new is released, don't hold on to them for long
+    return 5 * 60 * 1000;
+}
+
 bool Meta::BaseEntity::loadLocalFile()
 {
     const QString fname = QDir("meta").absoluteFilePath(localFilename());
@@ -117,9 +123,14 @@ void Meta::BaseEntity::load(Net::Mode loadType)
     {
         return;
     }
+    auto entry = APPLICATION->metacache()->resolveEntry("meta", localFilename());
+    // the server confirmed the file recently, no need to ask again
+    if(BaseEntity::isLoaded() && entry->isFresh(maxAge()))
+    {
+        return;
+    }
     m_updateTask = new NetJob(QObject::tr("Download of meta file %1").arg(localFilename()), APPLICATION->network());
     auto url = this->url();
-    auto entry = APPLICATION->metacache()->resolveEntry("meta", localFilename());
     entry->setStale(true);
     auto dl = Net::Download::makeCached(url, entry);
     /*
@@ -49,6 +49,9 @@ public:
 
     virtual QString localFilename() const = 0;
     virtual QUrl url() const;
+    /// How long, in milliseconds, a file confirmed by the meta server is trusted without asking again,
+    /// unless the server said otherwise.
+    virtual qint64 maxAge() const;
 
     bool isLoaded() const;
     bool shouldStartRemoteUpdate() const;
@@ -99,6 +99,16 @@ QString Meta::Version::localFilename() const
     return m_uid + '/' + m_version + ".json";
 }
 
+qint64 Meta::Version::maxAge() const
+{
+    // released versions practically never change, volatile ones are expected to
+    if(m_volatile)
+    {
+        return BaseEntity::maxAge();
+    }
+    return 60 * 60 * 1000;
+}
+
 void Meta::Version::setType(const QString &type)
 {
     m_type = type;
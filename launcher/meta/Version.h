@@ -83,6 +83,7 @@ public: /* con/des */
     void parse(const QJsonObject &obj) override;
 
     QString localFilename() const override;
+    qint64 maxAge() const override;
 
 public: // for usage by format parsers only
     void setType(const QString &type);
@@ -17,11 +17,13 @@
 #include <QDir>
 #include <QDirIterator>
 #include <QCryptographicHash>
-#include <QJsonParseError>
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QVariant>
+#include <QDataStream>
+#include <QDateTime>
+#include <QSaveFile>
 #include <QDebug>
+#include <QtConcurrentMap>
+#include <algorithm>
+#include <cctype>
 
 #include "AssetsUtils.h"
 #include "FileSystem.h"
@@ -32,6 +34,12 @@
 #include "Application.h"
 
 namespace {
+// written into reconstructed virtual folders, so unchanged ones don't have to be walked again.
+// The resources folder of an instance gets its stamp next to the index instead, see resourcesStampPath.
+const QString stampFileName = ".mmc-assets";
+// bump when the way folders are reconstructed changes
+const int stampVersion = 1;
+
 QSet<QString> collectPathsFromDir(QString dirPath)
 {
     QFileInfo dirInfo(dirPath);
@@ -43,123 +51,611 @@ QSet<QString> collectPathsFromDir(QString dirPath)
 
     QSet<QString> out;
 
-    QDirIterator iter(dirPath, QDirIterator::Subdirectories);
+    QDirIterator iter(dirPath, QDir::Files | QDir::Hidden | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
     while (iter.hasNext())
     {
-        QString value = iter.next();
-        QFileInfo info(value);
-        if(info.isFile())
-        {
-            out.insert(value);
-            qDebug() << value;
-        }
+        out.insert(iter.next());
     }
     return out;
 }
-}
 
+QByteArray makeStamp(const QString &assetsId, const QFileInfo &indexInfo)
+{
+    return QString("%1\n%2\n%3\n%4\n")
+        .arg(stampVersion)
+        .arg(assetsId)
+        .arg(indexInfo.size())
+        .arg(indexInfo.lastModified().toMSecsSinceEpoch())
+        .toUtf8();
+}
 
-namespace AssetsUtils
+// keeps the stamp of a resources folder out of the instance, where it would be exported and copied with it
+QString resourcesStampPath(const QString &indexPath, const QString &resourcesFolder)
 {
+    auto folderHash = QCryptographicHash::hash(QFileInfo(resourcesFolder).absoluteFilePath().toUtf8(), QCryptographicHash::Sha1);
+    return indexPath + "." + QString::fromLatin1(folderHash.toHex().left(16)) + stampFileName;
+}
 
 /*
- * Returns true on success, with index populated
- * index is undefined otherwise
+ * Streaming parser for asset indexes:
+ * {
+ *   "virtual": false,
+ *   "map_to_resources": false,
+ *   "objects": {
+ *     "icons/icon_16x16.png": {
+ *       "hash": "bdf48ef6b5d0d23bbb02e17d04865216179f510a",
+ *       "size": 3665
+ *     },
+ *     ...
+ *   }
+ * }
+ * Objects go straight into the index, nothing else is kept.
  */
-bool loadAssetsIndexJson(const QString &assetsId, const QString &path, AssetsIndex& index)
+class IndexParser
 {
-    /*
+public:
+    explicit IndexParser(const QByteArray &data)
+        : m_begin(data.constData()), m_pos(data.constData()), m_end(data.constData() + data.size())
+    {
+    }
+
+    bool parse(AssetsIndex &index)
     {
-      "objects": {
-        "icons/icon_16x16.png": {
-          "hash": "bdf48ef6b5d0d23bbb02e17d04865216179f510a",
-          "size": 3665
-        },
-        ...
+        index.clear();
+        if (!expect('{'))
+        {
+            return fail("the root should be an object");
+        }
+        if (!parseMembers([&](const QByteArray &key) {
+                if (key == "objects")
+                {
+                    return parseObjects(index);
+                }
+                if (key == "virtual")
+                {
+                    return parseFlag(index.isVirtual);
+                }
+                if (key == "map_to_resources")
+                {
+                    return parseFlag(index.mapToResources);
+                }
+                return skipValue(0);
+            }))
+        {
+            return false;
+        }
+        skipWhitespace();
+        if (m_pos != m_end)
+        {
+            return fail("unexpected data after the root object");
         }
-      }
+        return true;
     }
-    */
 
-    QFile file(path);
+    QString error() const
+    {
+        return m_error;
+    }
 
-    // Try to open the file and fail if we can't.
-    // TODO: We should probably report this error to the user.
-    if (!file.open(QIODevice::ReadOnly))
+private:
+    void skipWhitespace()
     {
-        qCritical() << "Failed to read assets index file" << path;
-        return false;
+        while (m_pos < m_end && (*m_pos == ' ' || *m_pos == '\n' || *m_pos == '\r' || *m_pos == '\t'))
+        {
+            m_pos++;
+        }
     }
-    index.id = assetsId;
 
-    // Read the file and close it.
-    QByteArray jsonData = file.readAll();
-    file.close();
+    bool peek(char c)
+    {
+        skipWhitespace();
+        return m_pos < m_end && *m_pos == c;
+    }
 
-    QJsonParseError parseError;
-    QJsonDocument jsonDoc = QJsonDocument::fromJson(jsonData, &parseError);
+    bool expect(char c)
+    {
+        if (!peek(c))
+        {
+            return false;
+        }
+        m_pos++;
+        return true;
+    }
 
-    // Fail if the JSON is invalid.
-    if (parseError.error != QJsonParseError::NoError)
+    bool fail(const char *what)
     {
-        qCritical() << "Failed to parse assets index file:" << parseError.errorString()
-                     << "at offset " << QString::number(parseError.offset);
+        if (m_error.isEmpty())
+        {
+            m_error = QString("%1 at offset %2").arg(what).arg(m_pos - m_begin);
+        }
         return false;
     }
 
-    // Make sure the root is an object.
-    if (!jsonDoc.isObject())
+    // Calls handleMember for every key of an object, after the opening brace was consumed
+    template <typename Handler>
+    bool parseMembers(Handler handleMember)
     {
-        qCritical() << "Invalid assets index JSON: Root should be an array.";
-        return false;
+        if (expect('}'))
+        {
+            return true;
+        }
+        QByteArray key;
+        while (true)
+        {
+            if (!parseString(key))
+            {
+                return fail("expected a key");
+            }
+            if (!expect(':'))
+            {
+                return fail("expected ':'");
+            }
+            if (!handleMember(key))
+            {
+                return false;
+            }
+            if (expect(','))
+            {
+                continue;
+            }
+            if (expect('}'))
+            {
+                return true;
+            }
+            return fail("expected ',' or '}'");
+        }
     }
 
-    QJsonObject root = jsonDoc.object();
+    bool parseObjects(AssetsIndex &index)
+    {
+        if (!expect('{'))
+        {
+            // not what we expected, but that just means there are no objects
+            return skipValue(0);
+        }
+        return parseMembers([&](const QByteArray &path) {
+            QByteArray hash;
+            qint64 size = 0;
+            if (!parseObject(hash, size))
+            {
+                return false;
+            }
+            index.append(QString::fromUtf8(path), hash, size);
+            return true;
+        });
+    }
 
-    QJsonValue isVirtual = root.value("virtual");
-    if (!isVirtual.isUndefined())
+    bool parseObject(QByteArray &hash, qint64 &size)
     {
-        index.isVirtual = isVirtual.toBool(false);
+        if (!expect('{'))
+        {
+            return fail("expected an asset object");
+        }
+        QByteArray hexHash;
+        if (!parseMembers([&](const QByteArray &key) {
+                if (key == "hash")
+                {
+                    return parseString(hexHash) || fail("expected a string");
+                }
+                if (key == "size")
+                {
+                    double value = 0;
+                    if (!parseNumber(value))
+                    {
+                        return fail("expected a number");
+                    }
+                    size = value;
+                    return true;
+                }
+                return skipValue(0);
+            }))
+        {
+            return false;
+        }
+        hash = QByteArray::fromHex(hexHash);
+        if (hexHash.size() != 40 || hash.size() != 20)
+        {
+            return fail("asset object without a valid hash");
+        }
+        return true;
     }
 
-    QJsonValue mapToResources = root.value("map_to_resources");
-    if (!mapToResources.isUndefined())
+    bool parseFlag(bool &flag)
     {
-        index.mapToResources = mapToResources.toBool(false);
+        skipWhitespace();
+        if (matchLiteral("true"))
+        {
+            flag = true;
+            return true;
+        }
+        flag = false;
+        return matchLiteral("false") || skipValue(0);
     }
 
-    QJsonValue objects = root.value("objects");
-    QVariantMap map = objects.toVariant().toMap();
+    bool matchLiteral(const char *literal)
+    {
+        auto length = qstrlen(literal);
+        if (m_end - m_pos < qint64(length) || qstrncmp(m_pos, literal, length) != 0)
+        {
+            return false;
+        }
+        m_pos += length;
+        return true;
+    }
 
-    for (QVariantMap::const_iterator iter = map.begin(); iter != map.end(); ++iter)
+    bool parseNumber(double &value)
     {
-        // qDebug() << iter.key();
+        skipWhitespace();
+        auto start = m_pos;
+        while (m_pos < m_end && (isdigit(uchar(*m_pos)) || *m_pos == '-' || *m_pos == '+' || *m_pos == '.' || *m_pos == 'e' || *m_pos == 'E'))
+        {
+            m_pos++;
+        }
+        bool ok = false;
+        value = QByteArray(start, m_pos - start).toDouble(&ok);
+        return ok;
+    }
 
-        QVariant variant = iter.value();
-        QVariantMap nested_objects = variant.toMap();
+    static int hexValue(char c)
+    {
+        if (c >= '0' && c <= '9')
+            return c - '0';
+        if (c >= 'a' && c <= 'f')
+            return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F')
+            return c - 'A' + 10;
+        return -1;
+    }
 
-        AssetObject object;
+    bool parseCodeUnit(uint &unit)
+    {
+        if (m_end - m_pos < 4)
+        {
+            return false;
+        }
+        unit = 0;
+        for (int i = 0; i < 4; i++)
+        {
+            int digit = hexValue(*m_pos++);
+            if (digit < 0)
+            {
+                return false;
+            }
+            unit = unit * 16 + digit;
+        }
+        return true;
+    }
 
-        for (QVariantMap::const_iterator nested_iter = nested_objects.begin();
-             nested_iter != nested_objects.end(); ++nested_iter)
+    static void appendUtf8(QByteArray &out, uint codePoint)
+    {
+        if (codePoint < 0x80)
+        {
+            out.append(char(codePoint));
+        }
+        else if (codePoint < 0x800)
+        {
+            out.append(char(0xC0 | (codePoint >> 6)));
+            out.append(char(0x80 | (codePoint & 0x3F)));
+        }
+        else if (codePoint < 0x10000)
+        {
+            out.append(char(0xE0 | (codePoint >> 12)));
+            out.append(char(0x80 | ((codePoint >> 6) & 0x3F)));
+            out.append(char(0x80 | (codePoint & 0x3F)));
+        }
+        else
         {
-            // qDebug() << nested_iter.key() << nested_iter.value().toString();
-            QString key = nested_iter.key();
-            QVariant value = nested_iter.value();
+            out.append(char(0xF0 | (codePoint >> 18)));
+            out.append(char(0x80 | ((codePoint >> 12) & 0x3F)));
+            out.append(char(0x80 | ((codePoint >> 6) & 0x3F)));
+            out.append(char(0x80 | (codePoint & 0x3F)));
+        }
+    }
 
-            if (key == "hash")
+    // Reads a string into out as UTF-8, with escapes resolved
+    bool parseString(QByteArray &out)
+    {
+        if (!expect('"'))
+        {
+            return false;
+        }
+        out.clear();
+        while (true)
+        {
+            auto start = m_pos;
+            while (m_pos < m_end && *m_pos != '"' && *m_pos != '\\')
+            {
+                m_pos++;
+            }
+            out.append(start, m_pos - start);
+            if (m_pos >= m_end)
+            {
+                return fail("unterminated string");
+            }
+            if (*m_pos++ == '"')
+            {
+                return true;
+            }
+            if (m_pos >= m_end)
             {
-                object.hash = value.toString();
+                return fail("unterminated string");
             }
-            else if (key == "size")
+            char escaped = *m_pos++;
+            switch (escaped)
             {
-                object.size = value.toDouble();
+                case '"':
+                case '\\':
+                case '/':
+                    out.append(escaped);
+                    break;
+                case 'b':
+                    out.append('\b');
+                    break;
+                case 'f':
+                    out.append('\f');
+                    break;
+                case 'n':
+                    out.append('\n');
+                    break;
+                case 'r':
+                    out.append('\r');
+                    break;
+                case 't':
+                    out.append('\t');
+                    break;
+                case 'u':
+                {
+                    uint unit = 0;
+                    if (!parseCodeUnit(unit))
+                    {
+                        return fail("invalid unicode escape");
+                    }
+                    uint low = 0;
+                    if (QChar::isHighSurrogate(unit) && m_end - m_pos >= 6 && m_pos[0] == '\\' && m_pos[1] == 'u')
+                    {
+                        m_pos += 2;
+                        if (!parseCodeUnit(low) || !QChar::isLowSurrogate(low))
+                        {
+                            return fail("invalid unicode escape");
+                        }
+                        unit = QChar::surrogateToUcs4(ushort(unit), ushort(low));
+                    }
+                    appendUtf8(out, unit);
+                    break;
+                }
+                default:
+                    return fail("invalid escape sequence");
             }
         }
+    }
+
+    bool skipValue(int depth)
+    {
+        if (depth > 64)
+        {
+            return fail("nested too deeply");
+        }
+        skipWhitespace();
+        if (m_pos >= m_end)
+        {
+            return fail("unexpected end of data");
+        }
+        switch (*m_pos)
+        {
+            case '"':
+            {
+                QByteArray ignored;
+                return parseString(ignored);
+            }
+            case '{':
+                m_pos++;
+                return parseMembers([&](const QByteArray &) { return skipValue(depth + 1); });
+            case '[':
+            {
+                m_pos++;
+                if (expect(']'))
+                {
+                    return true;
+                }
+                while (true)
+                {
+                    if (!skipValue(depth + 1))
+                    {
+                        return false;
+                    }
+                    if (expect(','))
+                    {
+                        continue;
+                    }
+                    if (expect(']'))
+                    {
+                        return true;
+                    }
+                    return fail("expected ',' or ']'");
+                }
+            }
+            case 't':
+                return matchLiteral("true") || fail("invalid literal");
+            case 'f':
+                return matchLiteral("false") || fail("invalid literal");
+            case 'n':
+                return matchLiteral("null") || fail("invalid literal");
+            default:
+            {
+                double ignored;
+                return parseNumber(ignored) || fail("invalid value");
+            }
+        }
+    }
+
+    const char *m_begin;
+    const char *m_pos;
+    const char *m_end;
+    QString m_error;
+};
+
+const quint32 cacheMagic = 0x4D4D4149; // MMAI
+// bump when AssetsIndex or the parser change, so indexes get parsed again
+const quint32 cacheVersion = 1;
+
+QString cachePathFor(const QFileInfo &indexInfo)
+{
+    return FS::PathCombine(indexInfo.absolutePath(), indexInfo.completeBaseName() + ".mmcindex");
+}
+
+/*
+ * The cache starts with the flags, so they can be read without loading the objects.
+ * It is only valid for the index file with the size and modification time it was made from.
+ */
+bool readCache(const QString &cachePath, const QFileInfo &indexInfo, AssetsIndex &index, bool flagsOnly)
+{
+    QFile input(cachePath);
+    if (!input.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+    QDataStream in(&input);
+    in.setVersion(QDataStream::Qt_5_0);
+    quint32 magic = 0, version = 0;
+    qint64 indexSize = 0, indexModified = 0;
+    bool isVirtual = false, mapToResources = false;
+    in >> magic >> version >> indexSize >> indexModified >> isVirtual >> mapToResources;
+    if (in.status() != QDataStream::Ok || magic != cacheMagic || version != cacheVersion)
+    {
+        return false;
+    }
+    if (indexSize != indexInfo.size() || indexModified != indexInfo.lastModified().toMSecsSinceEpoch())
+    {
+        return false;
+    }
+    index.isVirtual = isVirtual;
+    index.mapToResources = mapToResources;
+    if (flagsOnly)
+    {
+        return true;
+    }
+    in >> index.pathData >> index.pathOffsets >> index.hashes >> index.sizes;
+    bool valid = in.status() == QDataStream::Ok
+        && index.pathOffsets.size() == index.sizes.size() + 1
+        && index.hashes.size() == index.sizes.size() * 20
+        && index.pathOffsets.first() == 0
+        && index.pathOffsets.last() == quint32(index.pathData.size());
+    if (!valid)
+    {
+        qWarning() << "Assets index cache" << cachePath << "is damaged, ignoring it.";
+        index.clear();
+        return false;
+    }
+    return true;
+}
+
+void writeCache(const QString &cachePath, const QFileInfo &indexInfo, const AssetsIndex &index)
+{
+    QSaveFile output(cachePath);
+    if (!output.open(QIODevice::WriteOnly))
+    {
+        qWarning() << "Couldn't open" << cachePath << "for writing:" << output.errorString();
+        return;
+    }
+    QDataStream out(&output);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << cacheMagic << cacheVersion << qint64(indexInfo.size()) << qint64(indexInfo.lastModified().toMSecsSinceEpoch())
+        << index.isVirtual << index.mapToResources;
+    out << index.pathData << index.pathOffsets << index.hashes << index.sizes;
+    if (out.status() != QDataStream::Ok || !output.commit())
+    {
+        qWarning() << "Couldn't write assets index cache" << cachePath;
+    }
+}
+
+struct AssetPlacement
+{
+    QString original;
+    QString target;
+};
+
+// objects are never modified in place, so folders only the launcher manages can share their data instead of copying it
+bool linkAsset(const AssetPlacement &placement)
+{
+    return FS::linkOrCopy(placement.original, placement.target);
+}
+
+// the resources folder is inside the game folder, where files get edited in place. A hard link would edit the object.
+bool copyAsset(const AssetPlacement &placement)
+{
+    return FS::reflinkOrCopy(placement.original, placement.target);
+}
+
+void removeEmptyFolders(const QString &root)
+{
+    QDirIterator iter(root, QDir::Dirs | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    QStringList folders;
+    while (iter.hasNext())
+    {
+        folders.append(iter.next());
+    }
+    // deepest first, so parents are empty by the time we get to them
+    std::sort(folders.begin(), folders.end(), [](const QString &a, const QString &b) { return a.size() > b.size(); });
+    for (auto &folder: folders)
+    {
+        QDir().rmdir(folder);
+    }
+}
+}
+
+namespace AssetsUtils
+{
+
+/*
+ * Returns true on success, with index populated
+ * index is undefined otherwise
+ */
+bool parseAssetsIndexJson(const QByteArray &data, AssetsIndex& index, QString *error)
+{
+    IndexParser parser(data);
+    if(!parser.parse(index))
+    {
+        if(error)
+        {
+            *error = parser.error();
+        }
+        return false;
+    }
+    return true;
+}
 
-        index.objects.insert(iter.key(), object);
+bool loadAssetsIndexJson(const QString &assetsId, const QString &path, AssetsIndex& index)
+{
+    QFileInfo indexInfo(path);
+    auto cachePath = cachePathFor(indexInfo);
+    index.clear();
+    index.id = assetsId;
+    if (readCache(cachePath, indexInfo, index, false))
+    {
+        return true;
+    }
+
+    QFile file(path);
+
+    // Try to open the file and fail if we can't.
+    // TODO: We should probably report this error to the user.
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        qCritical() << "Failed to read assets index file" << path;
+        return false;
     }
 
+    // Read the file and close it.
+    QByteArray jsonData = file.readAll();
+    file.close();
+
+    QString error;
+    if (!parseAssetsIndexJson(jsonData, index, &error))
+    {
+        qCritical() << "Failed to parse assets index file" << path << ":" << error;
+        return false;
+    }
+    writeCache(cachePath, indexInfo, index);
     return true;
 }
 
@@ -181,8 +677,9 @@ QDir getAssetsDir(const QString &assetsId, const QString &resourcesFolder)
         return virtualRoot;
     }
 
+    // only the flags are needed here, which the cached index has up front
     AssetsIndex index;
-    if(!AssetsUtils::loadAssetsIndexJson(assetsId, indexPath, index))
+    if(!readCache(cachePathFor(QFileInfo(indexPath)), QFileInfo(indexPath), index, true) && !AssetsUtils::loadAssetsIndexJson(assetsId, indexPath, index))
     {
         qCritical() << "Failed to load asset index file" << indexPath << "; can't determine assets path!";
         return virtualRoot;
@@ -241,44 +738,104 @@ bool reconstructAssets(QString assetsId, QString resourcesFolder)
         qDebug() << "Reconstructing resources folder at" << targetPath;
     }
 
-    if (!targetPath.isNull())
+    if (targetPath.isNull())
+    {
+        return true;
+    }
+
+    QFileInfo indexInfo(indexPath);
+    QString stampPath = FS::PathCombine(targetPath, stampFileName);
+    auto stamp = makeStamp(assetsId, indexInfo);
+    if (!index.isVirtual)
+    {
+        // written by older versions
+        QFile::remove(stampPath);
+        stampPath = resourcesStampPath(indexPath, targetPath);
+    }
+    // a stamp outside the folder doesn't go away with it, so it also has to match the folder
+    auto currentStamp = [&]() -> QByteArray
     {
-        auto presentFiles = collectPathsFromDir(targetPath);
-        for (QString map : index.objects.keys())
+        if (index.isVirtual)
         {
-            AssetObject asset_object = index.objects.value(map);
-            QString target_path = FS::PathCombine(targetPath, map);
-            QFile target(target_path);
+            return stamp;
+        }
+        QFileInfo folderInfo(targetPath);
+        return stamp + QByteArray::number(folderInfo.isDir() ? folderInfo.lastModified().toMSecsSinceEpoch() : -1) + '\n';
+    };
+    {
+        QFile stampFile(stampPath);
+        if (stampFile.open(QIODevice::ReadOnly) && stampFile.readAll() == currentStamp())
+        {
+            qDebug() << "Assets folder" << targetPath << "is up to date";
+            return true;
+        }
+    }
 
-            QString tlk = asset_object.hash.left(2);
+    auto presentFiles = collectPathsFromDir(targetPath);
+    presentFiles.remove(stampPath);
+    QList<AssetPlacement> placements;
+    int missingObjects = 0;
+    for (int i = 0; i < index.size(); i++)
+    {
+        QString target_path = FS::PathCombine(targetPath, index.path(i));
+        presentFiles.remove(target_path);
 
-            QString original_path = FS::PathCombine(objectDir.path(), tlk, asset_object.hash);
-            QFile original(original_path);
-            if (!original.exists())
-                continue;
+        auto hash = index.hashString(i);
+        QString original_path = FS::PathCombine(objectDir.path(), hash.left(2), hash);
+        if (!QFileInfo::exists(original_path))
+        {
+            missingObjects++;
+            continue;
+        }
+        if (!QFileInfo::exists(target_path))
+        {
+            placements.append({original_path, target_path});
+        }
+    }
 
-            presentFiles.remove(target_path);
+    if (index.isVirtual)
+    {
+        QtConcurrent::blockingMap(placements, linkAsset);
+    }
+    else
+    {
+        QtConcurrent::blockingMap(placements, copyAsset);
+    }
+    int failed = 0;
+    for (auto &placement: placements)
+    {
+        if (!QFileInfo::exists(placement.target))
+        {
+            qWarning() << "Failed to place asset" << placement.original << "at" << placement.target;
+            failed++;
+        }
+    }
+    qDebug() << "Placed" << placements.size() - failed << "assets in" << targetPath;
 
-            if (!target.exists())
+    if(removeLeftovers)
+    {
+        for(auto & file: presentFiles)
+        {
+            if (!QFile::remove(file))
             {
-                QFileInfo info(target_path);
-                QDir target_dir = info.dir();
-
-                qDebug() << target_dir.path();
-                FS::ensureFolderPathExists(target_dir.path());
-
-                bool couldCopy = original.copy(target_path);
-                qDebug() << " Copying" << original_path << "to" << target_path << QString::number(couldCopy);
+                qWarning() << "Failed to remove leftover asset" << file;
             }
         }
+        if (!presentFiles.isEmpty())
+        {
+            qDebug() << "Removed" << presentFiles.size() << "leftover files from" << targetPath;
+            removeEmptyFolders(targetPath);
+        }
+    }
 
-        // TODO: Write last used time to virtualRoot/.lastused
-        if(removeLeftovers)
+    // only remember complete folders, missing objects may still get downloaded later
+    if (!failed && !missingObjects)
+    {
+        auto written = currentStamp();
+        QSaveFile stampFile(stampPath);
+        if (!stampFile.open(QIODevice::WriteOnly) || stampFile.write(written) != written.size() || !stampFile.commit())
         {
-            for(auto & file: presentFiles)
-            {
-                qDebug() << "Would remove" << file;
-            }
+            qWarning() << "Failed to write assets stamp" << stampPath;
         }
     }
     return true;
@@ -318,12 +875,38 @@ QString AssetObject::getRelPath()
     return hash.left(2) + "/" + hash;
 }
 
+AssetObject AssetsIndex::object(int i) const
+{
+    AssetObject object;
+    object.hash = hashString(i);
+    object.size = sizes[i];
+    return object;
+}
+
+void AssetsIndex::clear()
+{
+    isVirtual = false;
+    mapToResources = false;
+    pathData.clear();
+    pathOffsets = {0};
+    hashes.clear();
+    sizes.clear();
+}
+
+void AssetsIndex::append(const QString &path, const QByteArray &hash, qint64 size)
+{
+    pathData.append(path);
+    pathOffsets.append(pathData.size());
+    hashes.append(hash);
+    sizes.append(size);
+}
+
 NetJob::Ptr AssetsIndex::getDownloadJob()
 {
     auto job = new NetJob(QObject::tr("Assets for %1").arg(id), APPLICATION->network());
-    for (auto &object : objects.values())
+    for (int i = 0; i < size(); i++)
     {
-        auto dl = object.getDownloadAction();
+        auto dl = object(i).getDownloadAction();
         if(dl)
         {
             job->addNetAction(dl);
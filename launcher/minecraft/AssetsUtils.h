@@ -17,6 +17,8 @@
 
 #include <QString>
 #include <QMap>
+#include <QVector>
+#include <QByteArray>
 #include "net/NetAction.h"
 #include "net/NetJob.h"
 
@@ -31,21 +33,61 @@ struct AssetObject
     qint64 size;
 };
 
+/**
+ * Parsed asset index.
+ *
+ * Indexes have thousands of objects and are loaded on every launch of older versions, so the objects
+ * are kept as parallel arrays: all paths in one string, and raw 20 byte SHA-1 hashes.
+ */
 struct AssetsIndex
 {
     NetJob::Ptr getDownloadJob();
 
+    int size() const
+    {
+        return sizes.size();
+    }
+    QString path(int i) const
+    {
+        return pathData.mid(pathOffsets[i], pathOffsets[i + 1] - pathOffsets[i]);
+    }
+    QByteArray hash(int i) const
+    {
+        return hashes.mid(i * 20, 20);
+    }
+    QString hashString(int i) const
+    {
+        return QString::fromLatin1(hash(i).toHex());
+    }
+    AssetObject object(int i) const;
+
+    void clear();
+    void append(const QString &path, const QByteArray &hash, qint64 size);
+
     QString id;
-    QMap<QString, AssetObject> objects;
     bool isVirtual = false;
     bool mapToResources = false;
+
+    QString pathData;
+    // offsets of the paths in pathData, with one extra entry for the end of the last path
+    QVector<quint32> pathOffsets = {0};
+    QByteArray hashes;
+    QVector<qint64> sizes;
 };
 
 /// FIXME: this is absolutely horrendous. REDO!!!!
 namespace AssetsUtils
 {
+/**
+ * Load the asset index at file.
+ *
+ * The parsed index is cached in a binary file next to it, which is used for as long as the index doesn't change.
+ */
 bool loadAssetsIndexJson(const QString &id, const QString &file, AssetsIndex& index);
 
+/// Parse asset index JSON, without touching the binary cache.
+bool parseAssetsIndexJson(const QByteArray &data, AssetsIndex& index, QString *error = nullptr);
+
 QDir getAssetsDir(const QString &assetsId, const QString &resourcesFolder);
 
 /// Reconstruct a virtual assets folder for the given assets ID and return the folder
@@ -0,0 +1,189 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QVariant>
+#include "TestUtil.h"
+
+#include "minecraft/AssetsUtils.h"
+#include <random>
+
+namespace {
+// about the size of the largest modern index: a few thousand sounds, languages and textures
+QByteArray generateIndex(int count)
+{
+    std::mt19937 rng(119);
+    static const char *folders[] = {"minecraft/sounds/ambient/cave", "minecraft/sounds/mob/zombie", "minecraft/lang", "minecraft/textures/entity", "icons"};
+    QJsonObject objects;
+    for(int i = 0; i < count; i++)
+    {
+        QByteArray hash;
+        for(int b = 0; b < 20; b++)
+        {
+            hash.append(char(rng() & 0xFF));
+        }
+        QJsonObject object;
+        object.insert("hash", QString::fromLatin1(hash.toHex()));
+        object.insert("size", double(rng() % 5000000));
+        objects.insert(QString("%1/asset_%2.ogg").arg(folders[i % 5]).arg(i), object);
+    }
+    QJsonObject root;
+    root.insert("objects", objects);
+    return QJsonDocument(root).toJson(QJsonDocument::Indented);
+}
+
+// What the launcher used to do
+bool referenceParse(const QByteArray &data, bool &isVirtual, bool &mapToResources, QMap<QString, QPair<QString, qint64>> &objects)
+{
+    QJsonParseError parseError;
+    QJsonDocument jsonDoc = QJsonDocument::fromJson(data, &parseError);
+    if (parseError.error != QJsonParseError::NoError || !jsonDoc.isObject())
+    {
+        return false;
+    }
+    QJsonObject root = jsonDoc.object();
+    isVirtual = root.value("virtual").toBool(false);
+    mapToResources = root.value("map_to_resources").toBool(false);
+    QVariantMap map = root.value("objects").toVariant().toMap();
+    for (auto iter = map.begin(); iter != map.end(); ++iter)
+    {
+        QVariantMap nested = iter.value().toMap();
+        objects.insert(iter.key(), qMakePair(nested.value("hash").toString(), qint64(nested.value("size").toDouble())));
+    }
+    return true;
+}
+
+QMap<QString, QPair<QString, qint64>> toMap(const AssetsIndex &index)
+{
+    QMap<QString, QPair<QString, qint64>> objects;
+    for(int i = 0; i < index.size(); i++)
+    {
+        objects.insert(index.path(i), qMakePair(index.hashString(i), index.sizes[i]));
+    }
+    return objects;
+}
+}
+
+class AssetsUtilsTest : public QObject
+{
+    Q_OBJECT
+
+    QTemporaryDir m_dir;
+    QByteArray m_largeIndex;
+
+private
+slots:
+    void initTestCase()
+    {
+        QVERIFY(m_dir.isValid());
+        m_largeIndex = generateIndex(4000);
+    }
+
+    void test_parse_data()
+    {
+        QTest::addColumn<QByteArray>("json");
+        QTest::newRow("empty") << QByteArray("{}");
+        QTest::newRow("flags") << QByteArray(R"({"virtual": true, "map_to_resources": true, "objects": {}})");
+        QTest::newRow("non-bool flags") << QByteArray(R"({"virtual": "yes", "map_to_resources": 1})");
+        QTest::newRow("escapes") << QByteArray(R"({"objects": {"a\/b\"c\\dé😀.ogg": {"size": 12, "hash": "bdf48ef6b5d0d23bbb02e17d04865216179f510a"}}})");
+        QTest::newRow("unknown members") << QByteArray(R"({"extra": [1, {"x": null}, -2.5e3], "objects": {"a": {"hash": "bdf48ef6b5d0d23bbb02e17d04865216179f510a", "size": 3665, "other": [true, false]}}})");
+        QTest::newRow("large") << m_largeIndex;
+    }
+    void test_parse()
+    {
+        QFETCH(QByteArray, json);
+        bool isVirtual = false, mapToResources = false;
+        QMap<QString, QPair<QString, qint64>> expected;
+        QVERIFY(referenceParse(json, isVirtual, mapToResources, expected));
+
+        AssetsIndex index;
+        QString error;
+        QVERIFY2(AssetsUtils::parseAssetsIndexJson(json, index, &error), qPrintable(error));
+        QCOMPARE(index.isVirtual, isVirtual);
+        QCOMPARE(index.mapToResources, mapToResources);
+        QCOMPARE(toMap(index), expected);
+    }
+
+    void test_parseInvalid_data()
+    {
+        QTest::addColumn<QByteArray>("json");
+        QTest::newRow("array root") << QByteArray("[]");
+        QTest::newRow("truncated") << m_largeIndex.left(m_largeIndex.size() / 2);
+        QTest::newRow("bad hash") << QByteArray(R"({"objects": {"a": {"hash": "xyz", "size": 1}}})");
+        QTest::newRow("garbage after root") << QByteArray("{} {}");
+    }
+    void test_parseInvalid()
+    {
+        QFETCH(QByteArray, json);
+        AssetsIndex index;
+        QString error;
+        QVERIFY(!AssetsUtils::parseAssetsIndexJson(json, index, &error));
+        QVERIFY(!error.isEmpty());
+    }
+
+    void test_cache()
+    {
+        auto path = m_dir.filePath("large.json");
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(m_largeIndex);
+        file.close();
+
+        AssetsIndex parsed;
+        QVERIFY(AssetsUtils::loadAssetsIndexJson("large", path, parsed));
+        QVERIFY(QFileInfo::exists(m_dir.filePath("large.mmcindex")));
+
+        AssetsIndex cached;
+        QVERIFY(AssetsUtils::loadAssetsIndexJson("large", path, cached));
+        QCOMPARE(cached.id, QString("large"));
+        QCOMPARE(cached.pathData, parsed.pathData);
+        QCOMPARE(cached.pathOffsets, parsed.pathOffsets);
+        QCOMPARE(cached.hashes, parsed.hashes);
+        QCOMPARE(cached.sizes, parsed.sizes);
+    }
+
+    void test_benchmark_data()
+    {
+        QTest::addColumn<int>("method");
+        QTest::newRow("QJsonDocument") << 0;
+        QTest::newRow("streaming") << 1;
+        QTest::newRow("cached") << 2;
+    }
+    void test_benchmark()
+    {
+        QFETCH(int, method);
+        auto path = m_dir.filePath("bench.json");
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(m_largeIndex);
+        file.close();
+        if(method == 2)
+        {
+            AssetsIndex warmup;
+            QVERIFY(AssetsUtils::loadAssetsIndexJson("bench", path, warmup));
+        }
+        QBENCHMARK
+        {
+            if(method == 0)
+            {
+                bool isVirtual, mapToResources;
+                QMap<QString, QPair<QString, qint64>> objects;
+                QVERIFY(referenceParse(m_largeIndex, isVirtual, mapToResources, objects));
+            }
+            else if(method == 1)
+            {
+                AssetsIndex index;
+                QVERIFY(AssetsUtils::parseAssetsIndexJson(m_largeIndex, index));
+            }
+            else
+            {
+                AssetsIndex index;
+                QVERIFY(AssetsUtils::loadAssetsIndexJson("bench", path, index));
+            }
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(AssetsUtilsTest)
+
+#include "AssetsUtils_test.moc"
@@ -0,0 +1,303 @@
+#include "LaunchManifest.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDebug>
+
+#include "minecraft/MinecraftInstance.h"
+#include "minecraft/PackProfile.h"
+#include "minecraft/Component.h"
+#include "minecraft/Library.h"
+#include "minecraft/AssetsUtils.h"
+#include "minecraft/VersionFilterData.h"
+#include "net/HttpMetaCache.h"
+#include "FileSystem.h"
+#include "BuildConfig.h"
+#include "Application.h"
+
+namespace {
+const quint32 manifestMagic = 0x4D4D4C4D; // MMLM
+// bump when anything that goes into the manifest changes
+const quint32 manifestVersion = 2;
+}
+
+QString LaunchManifest::path(MinecraftInstance* instance)
+{
+    return FS::PathCombine(APPLICATION->metacache()->getBasePath("general"), "launch", instance->id() + ".manifest");
+}
+
+LaunchManifest::FileStamp LaunchManifest::stamp(const QString& path)
+{
+    QFileInfo info(path);
+    FileStamp out;
+    out.path = info.absoluteFilePath();
+    if(info.exists())
+    {
+        out.size = info.size();
+        out.lastModified = info.lastModified().toMSecsSinceEpoch();
+    }
+    return out;
+}
+
+bool LaunchManifest::unchanged(const FileStamp& file)
+{
+    QFileInfo info(file.path);
+    if(!info.exists())
+    {
+        return file.size == -1;
+    }
+    return info.size() == file.size && info.lastModified().toMSecsSinceEpoch() == file.lastModified;
+}
+
+QStringList LaunchManifest::listPatches(const QString& patchesDir)
+{
+    return QDir(patchesDir).entryList({"*.json"}, QDir::Files, QDir::Name);
+}
+
+void LaunchManifest::record(MinecraftInstance* instance)
+{
+    auto components = instance->getPackProfile();
+    auto profile = components->getProfile();
+    if(!profile)
+    {
+        return;
+    }
+
+    LaunchManifest manifest;
+    manifest.m_path = path(instance);
+    manifest.m_launcherVersion = BuildConfig.printableVersionString();
+    manifest.m_refreshed = QDateTime::currentMSecsSinceEpoch();
+
+    manifest.m_packFiles.append(stamp(FS::PathCombine(instance->instanceRoot(), "mmc-pack.json")));
+    manifest.m_patchesDir = FS::PathCombine(instance->instanceRoot(), "patches");
+    manifest.m_patches = listPatches(manifest.m_patchesDir);
+    for(auto & patch: manifest.m_patches)
+    {
+        manifest.m_packFiles.append(stamp(FS::PathCombine(manifest.m_patchesDir, patch)));
+    }
+
+    for(int i = 0; i < components->rowCount(); i++)
+    {
+        auto component = components->getComponent(i);
+        if(component->isCustom())
+        {
+            continue;
+        }
+        manifest.m_components.append(qMakePair(component->getID(), component->getVersion()));
+        manifest.m_metadata.append(stamp(QDir("meta").absoluteFilePath(component->getID() + '/' + component->getVersion() + ".json")));
+    }
+
+    // everything LibrariesTask would have downloaded
+    QStringList files, natives, natives32, natives64;
+    QList<LibraryPtr> libraries = profile->getLibraries() + profile->getNativeLibraries() + profile->getMavenFiles();
+    if(profile->getMainJar())
+    {
+        libraries.append(profile->getMainJar());
+    }
+    for(auto & library: libraries)
+    {
+        library->getApplicableFiles(currentSystem, files, natives, natives32, natives64, instance->getLocalLibraryPath());
+    }
+    for(auto & jarMod: profile->getJarMods())
+    {
+        jarMod->getApplicableFiles(currentSystem, files, natives, natives32, natives64, instance->jarModsDir());
+    }
+    // and what FMLLibrariesTask put into the instance
+    auto fmlVersion = components->getComponentVersion("net.minecraft");
+    auto &fmlLibsMapping = g_VersionFilterData.fmlLibsMapping;
+    if(profile->hasTrait("legacyFML") && fmlLibsMapping.contains(fmlVersion) && components->getComponent("net.minecraftforge"))
+    {
+        for(auto & lib: fmlLibsMapping[fmlVersion])
+        {
+            files.append(FS::PathCombine(instance->libDir(), lib.filename));
+        }
+    }
+    for(auto & file: files + natives + natives32 + natives64)
+    {
+        manifest.m_files.append(stamp(file));
+    }
+    // and FoldersTask
+    manifest.m_gameRoot = QFileInfo(instance->gameRoot()).absoluteFilePath();
+
+    auto assets = profile->getMinecraftAssets();
+    if(assets)
+    {
+        manifest.m_assetsId = assets->id;
+        manifest.m_assetsIndex = stamp(QDir("assets/indexes").absoluteFilePath(assets->id + ".json"));
+    }
+
+    if(!manifest.save())
+    {
+        qWarning() << "Couldn't write launch manifest" << manifest.m_path;
+    }
+}
+
+QString LaunchManifest::findMetadataChanges() const
+{
+    for(auto & file: m_metadata)
+    {
+        if(!unchanged(file))
+        {
+            return QObject::tr("The metadata in %1 changed.").arg(file.path);
+        }
+    }
+    return QString();
+}
+
+QString LaunchManifest::findChanges() const
+{
+    if(m_launcherVersion != BuildConfig.printableVersionString())
+    {
+        return QObject::tr("The launcher was updated.");
+    }
+    if(listPatches(m_patchesDir) != m_patches)
+    {
+        return QObject::tr("Components were added or removed.");
+    }
+    for(auto & file: m_packFiles)
+    {
+        if(!unchanged(file))
+        {
+            return QObject::tr("The components in %1 changed.").arg(file.path);
+        }
+    }
+    if(!QFileInfo(m_gameRoot).isDir())
+    {
+        return QObject::tr("The game folder %1 is missing.").arg(m_gameRoot);
+    }
+    auto metadataChanges = findMetadataChanges();
+    if(!metadataChanges.isEmpty())
+    {
+        return metadataChanges;
+    }
+    for(auto & file: m_files)
+    {
+        if(!unchanged(file))
+        {
+            return QObject::tr("%1 changed.").arg(file.path);
+        }
+    }
+    if(m_assetsId.isEmpty())
+    {
+        return QString();
+    }
+    if(!unchanged(m_assetsIndex))
+    {
+        return QObject::tr("The asset index %1 changed.").arg(m_assetsIndex.path);
+    }
+    AssetsIndex index;
+    if(!AssetsUtils::loadAssetsIndexJson(m_assetsId, m_assetsIndex.path, index))
+    {
+        return QObject::tr("The asset index %1 can't be read.").arg(m_assetsIndex.path);
+    }
+    for(int i = 0; i < index.size(); i++)
+    {
+        QFileInfo object(index.object(i).getLocalPath());
+        if(!object.exists() || object.size() != index.sizes[i])
+        {
+            return QObject::tr("The asset %1 is missing.").arg(index.path(i));
+        }
+    }
+    return QString();
+}
+
+bool LaunchManifest::needsRefresh(qint64 interval) const
+{
+    return QDateTime::currentMSecsSinceEpoch() - m_refreshed >= interval;
+}
+
+bool LaunchManifest::markRefreshed()
+{
+    if(!findMetadataChanges().isEmpty())
+    {
+        return false;
+    }
+    m_refreshed = QDateTime::currentMSecsSinceEpoch();
+    return save();
+}
+
+std::shared_ptr<LaunchManifest> LaunchManifest::load(const QString& path)
+{
+    QFile input(path);
+    if(!input.open(QIODevice::ReadOnly))
+    {
+        return nullptr;
+    }
+    QDataStream in(&input);
+    in.setVersion(QDataStream::Qt_5_0);
+    auto readStamp = [&](FileStamp & file)
+    {
+        in >> file.path >> file.size >> file.lastModified;
+    };
+    auto readStamps = [&](QList<FileStamp> & files)
+    {
+        quint32 count = 0;
+        in >> count;
+        for(quint32 i = 0; i < count && in.status() == QDataStream::Ok; i++)
+        {
+            FileStamp file;
+            readStamp(file);
+            files.append(file);
+        }
+    };
+
+    quint32 magic = 0, version = 0;
+    in >> magic >> version;
+    if(in.status() != QDataStream::Ok || magic != manifestMagic || version != manifestVersion)
+    {
+        return nullptr;
+    }
+    auto manifest = std::make_shared<LaunchManifest>();
+    manifest->m_path = path;
+    in >> manifest->m_launcherVersion >> manifest->m_refreshed >> manifest->m_components >> manifest->m_patchesDir >> manifest->m_patches >> manifest->m_gameRoot;
+    readStamps(manifest->m_packFiles);
+    readStamps(manifest->m_metadata);
+    readStamps(manifest->m_files);
+    in >> manifest->m_assetsId;
+    readStamp(manifest->m_assetsIndex);
+    if(in.status() != QDataStream::Ok)
+    {
+        qWarning() << "Launch manifest" << path << "is damaged, ignoring it.";
+        return nullptr;
+    }
+    return manifest;
+}
+
+bool LaunchManifest::save() const
+{
+    if(!FS::ensureFilePathExists(m_path))
+    {
+        return false;
+    }
+    QSaveFile output(m_path);
+    if(!output.open(QIODevice::WriteOnly))
+    {
+        return false;
+    }
+    QDataStream out(&output);
+    out.setVersion(QDataStream::Qt_5_0);
+    auto writeStamp = [&](const FileStamp & file)
+    {
+        out << file.path << file.size << file.lastModified;
+    };
+    auto writeStamps = [&](const QList<FileStamp> & files)
+    {
+        out << quint32(files.size());
+        for(auto & file: files)
+        {
+            writeStamp(file);
+        }
+    };
+    out << manifestMagic << manifestVersion;
+    out << m_launcherVersion << m_refreshed << m_components << m_patchesDir << m_patches << m_gameRoot;
+    writeStamps(m_packFiles);
+    writeStamps(m_metadata);
+    writeStamps(m_files);
+    out << m_assetsId;
+    writeStamp(m_assetsIndex);
+    return out.status() == QDataStream::Ok && output.commit();
+}
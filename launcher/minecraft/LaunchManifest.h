@@ -0,0 +1,72 @@
+#pragma once
+
+#include <QString>
+#include <QList>
+#include <QStringList>
+#include <QPair>
+#include <memory>
+
+class MinecraftInstance;
+
+/**
+ * What the last successful online update of an instance resolved, and the files it left behind.
+ *
+ * As long as none of those files changed, a launch doesn't need to go online: the instance can be resolved from
+ * the metadata on disk. Files are compared by size and modification time. This covers the instance's pack files,
+ * the metadata of its components, every library and jar it uses including the FML libraries in the instance, the
+ * game folder, and the asset index with its objects.
+ */
+class LaunchManifest
+{
+public:
+    /// Record what the instance uses right now. Call right after a successful online update.
+    static void record(MinecraftInstance * instance);
+
+    static QString path(MinecraftInstance * instance);
+
+    /// Load the manifest at path. Only touches the disk, so it can be used from any thread.
+    static std::shared_ptr<LaunchManifest> load(const QString & path);
+
+    /// Returns what changed since the manifest was recorded, or an empty string if nothing did. Any thread.
+    QString findChanges() const;
+
+    /// True if the component metadata wasn't checked for updates in the last interval milliseconds
+    bool needsRefresh(qint64 interval) const;
+
+    /// Remember that the component metadata was checked just now, if it didn't change
+    bool markRefreshed();
+
+    /// uid and version of every component that has metadata
+    QList<QPair<QString, QString>> components() const
+    {
+        return m_components;
+    }
+
+private:
+    struct FileStamp
+    {
+        QString path;
+        // -1 for files that didn't exist
+        qint64 size = -1;
+        qint64 lastModified = 0;
+    };
+    static FileStamp stamp(const QString & path);
+    static bool unchanged(const FileStamp & file);
+    static QStringList listPatches(const QString & patchesDir);
+    QString findMetadataChanges() const;
+    bool save() const;
+
+private:
+    QString m_path;
+    QString m_launcherVersion;
+    qint64 m_refreshed = 0;
+    QList<QPair<QString, QString>> m_components;
+    QString m_patchesDir;
+    QStringList m_patches;
+    QList<FileStamp> m_packFiles;
+    QList<FileStamp> m_metadata;
+    QList<FileStamp> m_files;
+    QString m_gameRoot;
+    QString m_assetsId;
+    FileStamp m_assetsIndex;
+};
@@ -104,6 +104,12 @@ QList<NetAction::Ptr> Library::getDownloads(
         return true;
     };
 
+    forEachArtifact(system, add_download);
+    return out;
+}
+
+void Library::forEachArtifact(OpSys system, const std::function<void(QString storage, QString url, QString sha1)> &visitor) const
+{
     QString raw_storage = storageSuffix(system);
     if(m_mojangDownloads)
     {
@@ -123,14 +129,14 @@ QList<NetAction::Ptr> Library::getDownloads(
                     {
                         auto cooked_storage = raw_storage;
                         cooked_storage.replace("${arch}", "32");
-                        add_download(cooked_storage, nat32info->url, nat32info->sha1);
+                        visitor(cooked_storage, nat32info->url, nat32info->sha1);
                     }
                     auto nat64info = m_mojangDownloads->getDownloadInfo(nat64Classifier);
                     if(nat64info)
                     {
                         auto cooked_storage = raw_storage;
                         cooked_storage.replace("${arch}", "64");
-                        add_download(cooked_storage, nat64info->url, nat64info->sha1);
+                        visitor(cooked_storage, nat64info->url, nat64info->sha1);
                     }
                 }
                 else
@@ -138,7 +144,7 @@ QList<NetAction::Ptr> Library::getDownloads(
                     auto info = m_mojangDownloads->getDownloadInfo(nativeClassifier);
                     if(info)
                     {
-                        add_download(raw_storage, info->url, info->sha1);
+                        visitor(raw_storage, info->url, info->sha1);
                     }
                 }
             }
@@ -152,7 +158,7 @@ QList<NetAction::Ptr> Library::getDownloads(
             if(m_mojangDownloads->artifact)
             {
                 auto artifact = m_mojangDownloads->artifact;
-                add_download(raw_storage, artifact->url, artifact->sha1);
+                visitor(raw_storage, artifact->url, artifact->sha1);
             }
             else
             {
@@ -187,16 +193,29 @@ QList<NetAction::Ptr> Library::getDownloads(
         {
             QString cooked_storage = raw_storage;
             QString cooked_dl = raw_dl;
-            add_download(cooked_storage.replace("${arch}", "32"), cooked_dl.replace("${arch}", "32"), QString());
+            visitor(cooked_storage.replace("${arch}", "32"), cooked_dl.replace("${arch}", "32"), QString());
             cooked_storage = raw_storage;
             cooked_dl = raw_dl;
-            add_download(cooked_storage.replace("${arch}", "64"), cooked_dl.replace("${arch}", "64"), QString());
+            visitor(cooked_storage.replace("${arch}", "64"), cooked_dl.replace("${arch}", "64"), QString());
         }
         else
         {
-            add_download(raw_storage, raw_dl, QString());
+            visitor(raw_storage, raw_dl, QString());
         }
     }
+}
+
+QList<QPair<QString, QString>> Library::getCachedArtifacts(OpSys system) const
+{
+    QList<QPair<QString, QString>> out;
+    if(isLocal())
+    {
+        return out;
+    }
+    forEachArtifact(system, [&](QString storage, QString, QString sha1)
+    {
+        out.append(qMakePair(storage, sha1));
+    });
     return out;
 }
 
@@ -8,6 +8,7 @@
 #include <QDir>
 #include <QUrl>
 #include <memory>
+#include <functional>
 
 #include "Rule.h"
 #include "minecraft/OpSys.h"
@@ -155,6 +156,9 @@ public: /* methods */
     QList<NetAction::Ptr> getDownloads(OpSys system, class HttpMetaCache * cache,
                                      QStringList & failedLocalFiles, const QString & overridePath) const;
 
+    /// Get the metacache paths and expected SHA-1 sums (may be empty) of the shared files this library downloads
+    QList<QPair<QString, QString>> getCachedArtifacts(OpSys system) const;
+
 private: /* methods */
     /// the default storage prefix used by MultiMC
     static QString defaultStoragePrefix();
@@ -170,6 +174,9 @@ private: /* methods */
         return m_hint;
     }
 
+    /// Call visitor with the storage path, download URL and SHA-1 (if known) of every file this library has
+    void forEachArtifact(OpSys system, const std::function<void(QString storage, QString url, QString sha1)> &visitor) const;
+
 protected: /* data */
     /// the basic gradle dependency specifier.
     GradleSpecifier m_name;
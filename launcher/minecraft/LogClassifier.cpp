@@ -0,0 +1,95 @@
+#include "LogClassifier.h"
+
+#include <QRegularExpression>
+
+namespace {
+QRegularExpression compiled(const QString & pattern)
+{
+    QRegularExpression re(pattern);
+    re.optimize();
+    return re;
+}
+
+MessageLevel::Enum log4jLevel(const QStringRef & levelStr, MessageLevel::Enum level)
+{
+    if(levelStr == QLatin1String("INFO"))
+        return MessageLevel::Message;
+    if(levelStr == QLatin1String("WARN"))
+        return MessageLevel::Warning;
+    if(levelStr == QLatin1String("ERROR"))
+        return MessageLevel::Error;
+    if(levelStr == QLatin1String("FATAL"))
+        return MessageLevel::Fatal;
+    if(levelStr == QLatin1String("TRACE") || levelStr == QLatin1String("DEBUG"))
+        return MessageLevel::Debug;
+    return level;
+}
+
+MessageLevel::Enum forgeLevel(const QString & line, MessageLevel::Enum level)
+{
+    // every tag below starts with a bracket
+    if(!line.contains(QLatin1Char('[')))
+        return level;
+    if (line.contains(QLatin1String("[DEBUG]")))
+        return MessageLevel::Debug;
+    if (line.contains(QLatin1String("[WARNING]")))
+        return MessageLevel::Warning;
+    if (line.contains(QLatin1String("[SEVERE]")) || line.contains(QLatin1String("[STDERR]")))
+        return MessageLevel::Error;
+    if (line.contains(QLatin1String("[INFO]")) || line.contains(QLatin1String("[CONFIG]")) || line.contains(QLatin1String("[FINE]")) ||
+        line.contains(QLatin1String("[FINER]")) || line.contains(QLatin1String("[FINEST]")))
+        return MessageLevel::Message;
+    return level;
+}
+
+bool looksLikeStackTrace(const QString & line)
+{
+    //NOTE: this diverges from the real regexp. no unicode, the first section is + instead of *
+    static const QString javaSymbol = "([a-zA-Z_$][a-zA-Z\\d_$]*\\.)+[a-zA-Z_$][a-zA-Z\\d_$]*";
+    static const QRegularExpression atFrame = compiled("\\s+at " + javaSymbol);
+    static const QRegularExpression causedBy = compiled("Caused by: " + javaSymbol);
+    static const QRegularExpression exceptionName = compiled("([a-zA-Z_$][a-zA-Z\\d_$]*\\.)+[a-zA-Z_$]?[a-zA-Z\\d_$]*(Exception|Error|Throwable)");
+    static const QRegularExpression moreFrames = compiled("... \\d+ more$");
+
+    if (line.contains(QLatin1String("Exception in thread")))
+        return true;
+    if (line.contains(QLatin1String("at ")) && atFrame.match(line).hasMatch())
+        return true;
+    if (line.contains(QLatin1String("Caused by: ")) && causedBy.match(line).hasMatch())
+        return true;
+    if (line.contains(QLatin1Char('.')) &&
+        (line.contains(QLatin1String("Exception")) || line.contains(QLatin1String("Error")) || line.contains(QLatin1String("Throwable"))) &&
+        exceptionName.match(line).hasMatch())
+        return true;
+    if (line.contains(QLatin1String(" more")) && moreFrames.match(line).hasMatch())
+        return true;
+    return false;
+}
+}
+
+MessageLevel::Enum LogClassifier::guessLevel(const QString &line, MessageLevel::Enum level)
+{
+    static const QRegularExpression log4j = compiled("\\[(?<timestamp>[0-9:]+)\\] \\[[^/]+/(?<level>[^\\]]+)\\]");
+
+    // New style logs from log4j. The pattern can't match without the "] [" between timestamp and thread.
+    bool isLog4j = false;
+    if(line.contains(QLatin1String("] [")))
+    {
+        auto match = log4j.match(line);
+        if(match.hasMatch())
+        {
+            isLog4j = true;
+            level = log4jLevel(match.capturedRef(2), level);
+        }
+    }
+    if(!isLog4j)
+    {
+        // Old style forge logs
+        level = forgeLevel(line, level);
+    }
+    if (line.contains(QLatin1String("overwriting existing")))
+        return MessageLevel::Fatal;
+    if (looksLikeStackTrace(line))
+        return MessageLevel::Error;
+    return level;
+}
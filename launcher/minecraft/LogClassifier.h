@@ -0,0 +1,16 @@
+#pragma once
+
+#include <QString>
+
+#include "MessageLevel.h"
+
+/**
+ * Guesses the level of Minecraft log output that didn't come with one.
+ *
+ * Called for every line the game prints, so everything here is compiled once and the regular
+ * expressions only run when a cheap literal check says they could possibly match.
+ */
+namespace LogClassifier
+{
+MessageLevel::Enum guessLevel(const QString &line, MessageLevel::Enum level);
+}
@@ -28,6 +28,7 @@
 #include "minecraft/launch/ReconstructAssets.h"
 #include "minecraft/launch/ScanModFolders.h"
 #include "minecraft/launch/VerifyJavaInstall.h"
+#include "minecraft/launch/VerifyLaunchManifest.h"
 
 #include "java/JavaUtils.h"
 
@@ -44,10 +45,13 @@
 
 #include "PackProfile.h"
 #include "AssetsUtils.h"
+#include "LogClassifier.h"
 #include "MinecraftUpdate.h"
 #include "MinecraftLoadAndCheck.h"
 #include "minecraft/gameoptions/GameOptions.h"
 #include "minecraft/update/FoldersTask.h"
+#include "minecraft/update/MetadataRefreshTask.h"
+#include "minecraft/LaunchManifest.h"
 #include "minecraft/VersionFilterData.h"
 
 #define IBUS "@im=ibus"
@@ -190,10 +194,19 @@ QString MinecraftInstance::binRoot() const
 
 QString MinecraftInstance::getNativePath() const
 {
+    if(!m_nativePath.isEmpty())
+    {
+        return m_nativePath;
+    }
     QDir natives_dir(FS::PathCombine(instanceRoot(), "natives/"));
     return natives_dir.absolutePath();
 }
 
+void MinecraftInstance::setNativePath(const QString& path)
+{
+    m_nativePath = path;
+}
+
 QString MinecraftInstance::getLocalLibraryPath() const
 {
     QDir libraries_dir(FS::PathCombine(instanceRoot(), "libraries/"));
@@ -736,49 +749,7 @@ QMap<QString, QString> MinecraftInstance::createCensorFilterFromSession(AuthSess
 
 MessageLevel::Enum MinecraftInstance::guessLevel(const QString &line, MessageLevel::Enum level)
 {
-    QRegularExpression re("\\[(?<timestamp>[0-9:]+)\\] \\[[^/]+/(?<level>[^\\]]+)\\]");
-    auto match = re.match(line);
-    if(match.hasMatch())
-    {
-        // New style logs from log4j
-        QString timestamp = match.captured("timestamp");
-        QString levelStr = match.captured("level");
-        if(levelStr == "INFO")
-            level = MessageLevel::Message;
-        if(levelStr == "WARN")
-            level = MessageLevel::Warning;
-        if(levelStr == "ERROR")
-            level = MessageLevel::Error;
-        if(levelStr == "FATAL")
-            level = MessageLevel::Fatal;
-        if(levelStr == "TRACE" || levelStr == "DEBUG")
-            level = MessageLevel::Debug;
-    }
-    else
-    {
-        // Old style forge logs
-        if (line.contains("[INFO]") || line.contains("[CONFIG]") || line.contains("[FINE]") ||
-            line.contains("[FINER]") || line.contains("[FINEST]"))
-            level = MessageLevel::Message;
-        if (line.contains("[SEVERE]") || line.contains("[STDERR]"))
-            level = MessageLevel::Error;
-        if (line.contains("[WARNING]"))
-            level = MessageLevel::Warning;
-        if (line.contains("[DEBUG]"))
-            level = MessageLevel::Debug;
-    }
-    if (line.contains("overwriting existing"))
-        return MessageLevel::Fatal;
-    //NOTE: this diverges from the real regexp. no unicode, the first section is + instead of *
-    static const QString javaSymbol = "([a-zA-Z_$][a-zA-Z\\d_$]*\\.)+[a-zA-Z_$][a-zA-Z\\d_$]*";
-    if (line.contains("Exception in thread")
-        || line.contains(QRegularExpression("\\s+at " + javaSymbol))
-        || line.contains(QRegularExpression("Caused by: " + javaSymbol))
-        || line.contains(QRegularExpression("([a-zA-Z_$][a-zA-Z\\d_$]*\\.)+[a-zA-Z_$]?[a-zA-Z\\d_$]*(Exception|Error|Throwable)"))
-        || line.contains(QRegularExpression("... \\d+ more$"))
-        )
-        return MessageLevel::Error;
-    return level;
+    return LogClassifier::guessLevel(line, level);
 }
 
 IPathMatcher::Ptr MinecraftInstance::getLogFileMatcher()
@@ -847,6 +818,26 @@ Task::Ptr MinecraftInstance::createUpdateTask(Net::Mode mode)
     return nullptr;
 }
 
+Task::Ptr MinecraftInstance::createLaunchUpdateTask(std::shared_ptr<LaunchManifest> manifest)
+{
+    auto task = new MinecraftLoadAndCheck(this);
+    qint64 interval = APPLICATION->settings()->get("MetadataRefreshInterval").toInt() * 60000ll;
+    if(manifest->needsRefresh(interval))
+    {
+        // not before the instance is loaded, the refresh changes the metadata it is loaded from
+        connect(task, &Task::succeeded, this, [this, manifest]()
+        {
+            if(m_metadataRefresh && m_metadataRefresh->isRunning())
+            {
+                return;
+            }
+            m_metadataRefresh = new MetadataRefreshTask(manifest);
+            m_metadataRefresh->start();
+        });
+    }
+    return Task::Ptr(task);
+}
+
 shared_qobject_ptr<LaunchTask> MinecraftInstance::createLaunchTask(AuthSessionPtr session, QuickPlayTargetPtr quickPlayTarget)
 {
     // FIXME: get rid of shared_from_this ...
@@ -916,7 +907,9 @@ shared_qobject_ptr<LaunchTask> MinecraftInstance::createLaunchTask(AuthSessionPt
         if(!session->demo) {
             process->appendStep(new ClaimAccount(pptr, session));
         }
-        process->appendStep(new Update(pptr, Net::Mode::Online));
+        auto update = new Update(pptr, Net::Mode::Online);
+        process->appendStep(new VerifyLaunchManifest(pptr, update));
+        process->appendStep(update);
     }
     else
     {
@@ -1004,7 +997,9 @@ std::shared_ptr<ModFolderModel> MinecraftInstance::loaderModList() const
 {
     if (!m_loader_mod_list)
     {
-        m_loader_mod_list.reset(new ModFolderModel(modsRoot()));
+        // older versions kept the cache in the instance
+        FS::deletePath(FS::PathCombine(instanceRoot(), "modcache"));
+        m_loader_mod_list.reset(new ModFolderModel(modsRoot(), FS::PathCombine(cacheRoot(), "mods.dat")));
         m_loader_mod_list->disableInteraction(isRunning());
         connect(this, &BaseInstance::runningStatusChanged, m_loader_mod_list.get(), &ModFolderModel::disableInteraction);
     }
@@ -1015,7 +1010,7 @@ std::shared_ptr<ModFolderModel> MinecraftInstance::coreModList() const
 {
     if (!m_core_mod_list)
     {
-        m_core_mod_list.reset(new ModFolderModel(coreModsDir()));
+        m_core_mod_list.reset(new ModFolderModel(coreModsDir(), FS::PathCombine(cacheRoot(), "coremods.dat")));
         m_core_mod_list->disableInteraction(isRunning());
         connect(this, &BaseInstance::runningStatusChanged, m_core_mod_list.get(), &ModFolderModel::disableInteraction);
     }
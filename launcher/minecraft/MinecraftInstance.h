@@ -11,6 +11,7 @@ class WorldList;
 class GameOptions;
 class LaunchStep;
 class PackProfile;
+class LaunchManifest;
 
 class MinecraftInstance: public BaseInstance
 {
@@ -59,6 +60,8 @@ public:
 
     // where to put the natives during/before launch
     QString getNativePath() const;
+    // use an already prepared natives folder for this launch, an empty path goes back to the instance one
+    void setNativePath(const QString & path);
 
     // where the instance-local libraries should be
     QString getLocalLibraryPath() const;
@@ -78,6 +81,8 @@ public:
 
     //////  Launch stuff //////
     Task::Ptr createUpdateTask(Net::Mode mode) override;
+    // nothing changed since the manifest was recorded, so the launch only needs to load the instance, see VerifyLaunchManifest
+    Task::Ptr createLaunchUpdateTask(std::shared_ptr<LaunchManifest> manifest);
     shared_qobject_ptr<LaunchTask> createLaunchTask(AuthSessionPtr account, QuickPlayTargetPtr quickPlayTarget) override;
     QStringList extraArguments() const override;
     QStringList verboseDescription(AuthSessionPtr session, QuickPlayTargetPtr quickPlayTarget) override;
@@ -127,6 +132,8 @@ protected: // data
     mutable std::shared_ptr<ModFolderModel> m_texture_pack_list;
     mutable std::shared_ptr<WorldList> m_world_list;
     mutable std::shared_ptr<GameOptions> m_game_options;
+    QString m_nativePath;
+    Task::Ptr m_metadataRefresh;
 };
 
 typedef std::shared_ptr<MinecraftInstance> MinecraftInstancePtr;
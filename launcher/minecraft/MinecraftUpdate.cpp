@@ -30,6 +30,7 @@
 #include "update/LibrariesTask.h"
 #include "update/FMLLibrariesTask.h"
 #include "update/AssetUpdateTask.h"
+#include "LaunchManifest.h"
 
 #include <meta/Index.h>
 #include <meta/Version.h>
@@ -38,140 +39,200 @@ MinecraftUpdate::MinecraftUpdate(MinecraftInstance *inst, QObject *parent) : Tas
 {
 }
 
+int MinecraftUpdate::addStage(std::shared_ptr<Task> task, const QList<int> & dependencies)
+{
+    Stage stage;
+    stage.task = task;
+    stage.dependencies = dependencies;
+    m_stages.append(stage);
+    return m_stages.size() - 1;
+}
+
 void MinecraftUpdate::executeTask()
 {
-    m_tasks.clear();
+    m_stages.clear();
+    m_stagesDone = 0;
+
     // create folders
-    {
-        m_tasks.append(std::make_shared<FoldersTask>(m_inst));
-    }
+    auto folders = addStage(std::make_shared<FoldersTask>(m_inst));
 
     // add metadata update task if necessary
+    QList<int> metadata;
     {
         auto components = m_inst->getPackProfile();
         components->reload(Net::Mode::Online);
         auto task = components->getCurrentTask();
         if(task)
         {
-            m_tasks.append(task.unwrap());
+            metadata.append(addStage(task.unwrap()));
         }
     }
 
     // libraries download
-    {
-        m_tasks.append(std::make_shared<LibrariesTask>(m_inst));
-    }
+    addStage(std::make_shared<LibrariesTask>(m_inst), metadata);
 
     // FML libraries download and copy into the instance
-    {
-        m_tasks.append(std::make_shared<FMLLibrariesTask>(m_inst));
-    }
+    addStage(std::make_shared<FMLLibrariesTask>(m_inst), metadata + QList<int>{folders});
 
     // assets update
-    {
-        m_tasks.append(std::make_shared<AssetUpdateTask>(m_inst));
-    }
+    addStage(std::make_shared<AssetUpdateTask>(m_inst), metadata);
 
-    if(!m_preFailure.isEmpty())
-    {
-        emitFailed(m_preFailure);
-        return;
-    }
-    next();
+    startReadyStages();
 }
 
-void MinecraftUpdate::next()
+void MinecraftUpdate::startReadyStages()
 {
-    if(m_abort)
+    for(int i = 0; i < m_stages.size(); i++)
     {
-        emitFailed(tr("Aborted by user."));
-        return;
-    }
-    if(m_failed_out_of_order)
-    {
-        emitFailed(m_fail_reason);
-        return;
+        // a stage that finished right away may have finished everything
+        if(!isRunning())
+        {
+            return;
+        }
+        if(m_stages[i].started)
+        {
+            continue;
+        }
+        bool ready = true;
+        for(auto dependency: m_stages[i].dependencies)
+        {
+            ready &= m_stages[dependency].done;
+        }
+        if(!ready)
+        {
+            continue;
+        }
+        m_stages[i].started = true;
+        auto task = m_stages[i].task;
+        // the metadata update is started by the pack profile, it may be done already
+        if(task->isFinished())
+        {
+            if(!task->wasSuccessful())
+            {
+                failWith(task->failReason());
+                return;
+            }
+            stageSucceeded(i);
+            continue;
+        }
+        connect(task.get(), &Task::succeeded, this, &MinecraftUpdate::subtaskSucceeded);
+        connect(task.get(), &Task::failed, this, &MinecraftUpdate::subtaskFailed);
+        connect(task.get(), &Task::progress, this, &MinecraftUpdate::subtaskProgress);
+        connect(task.get(), &Task::status, this, &MinecraftUpdate::setStatus);
+        // if the task is already running, do not start it again
+        if(!task->isRunning())
+        {
+            task->start();
+        }
     }
-    m_currentTask ++;
-    if(m_currentTask > 0)
+}
+
+int MinecraftUpdate::findStage(QObject * task) const
+{
+    for(int i = 0; i < m_stages.size(); i++)
     {
-        auto task = m_tasks[m_currentTask - 1];
-        disconnect(task.get(), &Task::succeeded, this, &MinecraftUpdate::subtaskSucceeded);
-        disconnect(task.get(), &Task::failed, this, &MinecraftUpdate::subtaskFailed);
-        disconnect(task.get(), &Task::progress, this, &MinecraftUpdate::progress);
-        disconnect(task.get(), &Task::status, this, &MinecraftUpdate::setStatus);
+        if(m_stages[i].task.get() == task)
+        {
+            return i;
+        }
     }
-    if(m_currentTask == m_tasks.size())
-    {
+    return -1;
+}
+
+void MinecraftUpdate::stageSucceeded(int index)
+{
+    auto & stage = m_stages[index];
+    disconnect(stage.task.get(), nullptr, this, nullptr);
+    stage.done = true;
+    m_stagesDone++;
+    updateProgress();
+    if(m_stagesDone == m_stages.size())
+    {
+        // lets the next launch skip all this if nothing changes in the meantime
+        LaunchManifest::record(m_inst);
         emitSucceeded();
         return;
     }
-    auto task = m_tasks[m_currentTask];
-    // if the task is already finished by the time we look at it, skip it
-    if(task->isFinished())
-    {
-        qCritical() << "MinecraftUpdate: Skipping finished subtask" << m_currentTask << ":" << task.get();
-        next();
-    }
-    connect(task.get(), &Task::succeeded, this, &MinecraftUpdate::subtaskSucceeded);
-    connect(task.get(), &Task::failed, this, &MinecraftUpdate::subtaskFailed);
-    connect(task.get(), &Task::progress, this, &MinecraftUpdate::progress);
-    connect(task.get(), &Task::status, this, &MinecraftUpdate::setStatus);
-    // if the task is already running, do not start it again
-    if(!task->isRunning())
-    {
-        task->start();
-    }
+    startReadyStages();
 }
 
 void MinecraftUpdate::subtaskSucceeded()
 {
-    if(isFinished())
+    if(!isRunning())
     {
         qCritical() << "MinecraftUpdate: Subtask" << sender() << "succeeded, but work was already done!";
         return;
     }
-    auto senderTask = QObject::sender();
-    auto currentTask = m_tasks[m_currentTask].get();
-    if(senderTask != currentTask)
+    auto index = findStage(sender());
+    if(index < 0 || m_stages[index].done)
     {
-        qDebug() << "MinecraftUpdate: Subtask" << sender() << "succeeded out of order.";
         return;
     }
-    next();
+    stageSucceeded(index);
 }
 
 void MinecraftUpdate::subtaskFailed(QString error)
 {
-    if(isFinished())
+    if(!isRunning())
     {
-        qCritical() << "MinecraftUpdate: Subtask" << sender() << "failed, but work was already done!";
+        qDebug() << "MinecraftUpdate: Subtask" << sender() << "failed after the update was over:" << error;
         return;
     }
-    auto senderTask = QObject::sender();
-    auto currentTask = m_tasks[m_currentTask].get();
-    if(senderTask != currentTask)
+    failWith(m_abort ? tr("Aborted by user.") : error);
+}
+
+void MinecraftUpdate::subtaskProgress(qint64 current, qint64 total)
+{
+    auto index = findStage(sender());
+    if(index < 0)
     {
-        qDebug() << "MinecraftUpdate: Subtask" << sender() << "failed out of order.";
-        m_failed_out_of_order = true;
-        m_fail_reason = error;
         return;
     }
-    emitFailed(error);
+    m_stages[index].current = current;
+    m_stages[index].total = total;
+    updateProgress();
 }
 
+void MinecraftUpdate::updateProgress()
+{
+    // every stage counts the same, whatever unit it reports its progress in
+    const qint64 stageWeight = 1000;
+    qint64 current = 0;
+    for(auto & stage: m_stages)
+    {
+        if(stage.done)
+        {
+            current += stageWeight;
+        }
+        else if(stage.total > 0)
+        {
+            current += stageWeight * qBound<qint64>(0, stage.current, stage.total) / stage.total;
+        }
+    }
+    setProgress(current, stageWeight * m_stages.size());
+}
 
-bool MinecraftUpdate::abort()
+void MinecraftUpdate::failWith(const QString & reason)
 {
-    if(!m_abort)
+    // fail first, so the stages aborted below don't get here again
+    emitFailed(reason);
+    for(auto & stage: m_stages)
     {
-        m_abort = true;
-        auto task = m_tasks[m_currentTask];
-        if(task->canAbort())
+        if(stage.started && !stage.done && stage.task->isRunning() && stage.task->canAbort())
         {
-            return task->abort();
+            stage.task->abort();
         }
     }
+}
+
+bool MinecraftUpdate::abort()
+{
+    if(!isRunning())
+    {
+        return true;
+    }
+    m_abort = true;
+    failWith(tr("Aborted by user."));
     return true;
 }
 
@@ -27,6 +27,13 @@
 class MinecraftVersion;
 class MinecraftInstance;
 
+/**
+ * Gets everything an instance needs to launch.
+ *
+ * The update is made of stages that run as soon as the stages they depend on succeed. Libraries and assets only
+ * need the component metadata, so they download at the same time and share the connections of all network jobs.
+ * The first failure aborts everything else that is still running.
+ */
 class MinecraftUpdate : public Task
 {
     Q_OBJECT
@@ -42,16 +49,28 @@ slots:
     bool abort() override;
     void subtaskSucceeded();
     void subtaskFailed(QString error);
+    void subtaskProgress(qint64 current, qint64 total);
 
 private:
-    void next();
+    struct Stage
+    {
+        std::shared_ptr<Task> task;
+        QList<int> dependencies;
+        bool started = false;
+        bool done = false;
+        qint64 current = 0;
+        qint64 total = 0;
+    };
+    int addStage(std::shared_ptr<Task> task, const QList<int> & dependencies = {});
+    int findStage(QObject * task) const;
+    void startReadyStages();
+    void stageSucceeded(int index);
+    void updateProgress();
+    void failWith(const QString & reason);
 
 private:
     MinecraftInstance *m_inst = nullptr;
-    QList<std::shared_ptr<Task>> m_tasks;
-    QString m_preFailure;
-    int m_currentTask = -1;
+    QList<Stage> m_stages;
+    int m_stagesDone = 0;
     bool m_abort = false;
-    bool m_failed_out_of_order = false;
-    QString m_fail_reason;
 };
@@ -21,7 +21,16 @@
 #include <quazipdir.h>
 #include "MMCZip.h"
 #include "FileSystem.h"
+#include "Application.h"
+#include "net/HttpMetaCache.h"
 #include <QDir>
+#include <QDateTime>
+#include <QDirIterator>
+#include <QCryptographicHash>
+#include <QUuid>
+#include <QtConcurrentMap>
+
+#include <algorithm>
 
 #ifdef major
     #undef major
@@ -80,10 +89,138 @@ static bool unzipNatives(QString source, QString targetFolder, bool applyJnilibH
     return true;
 }
 
+namespace {
+// bump when the way natives are extracted changes
+const int cacheFormatVersion = 2;
+// natives folders kept around, most recently used first
+const int maxCachedFolders = 16;
+// folders used this recently may belong to a game that is still running, they are never pruned
+const qint64 pruneGraceMs = 24 * 60 * 60 * 1000;
+// staging folders of launches that didn't finish, older than this, are removed
+const qint64 stalePartAgeMs = 24 * 60 * 60 * 1000;
+// written last into a finished folder. Only folders that have it are used, its modification time is when it was last used.
+const char * completeMarker = ".complete";
+
+QString markerPath(const QString &folder)
+{
+    return FS::PathCombine(folder, completeMarker);
+}
+
+bool isComplete(const QString &folder)
+{
+    return QFileInfo(markerPath(folder)).isFile();
+}
+
+// the marker goes first, so a folder that can only be partially removed is never used again
+bool removeCachedFolder(const QString &folder)
+{
+    QFile::remove(markerPath(folder));
+    return QDir(folder).removeRecursively();
+}
+
+struct NativesJob
+{
+    QString source;
+    QString target;
+    bool applyJnilibHack = false;
+    bool nativeOpenAL = false;
+    bool nativeGLFW = false;
+};
+
+bool runNativesJob(const NativesJob &job)
+{
+    return unzipNatives(job.source, job.target, job.applyJnilibHack, job.nativeOpenAL, job.nativeGLFW);
+}
+
+/*
+ * The extracted folder depends on all the native jars, their order (later ones win) and the flags that decide
+ * which files get extracted and how they are named. Jars are identified by absolute path, size and modification
+ * time, like in ModMinecraftJar. Reading them would be more thorough, but this runs on every launch.
+ */
+QString nativesKey(const QStringList &sources, bool applyJnilibHack, bool nativeOpenAL, bool nativeGLFW)
+{
+    QCryptographicHash key(QCryptographicHash::Sha1);
+    key.addData(QString("natives %1 %2 %3 %4\n").arg(cacheFormatVersion).arg(int(applyJnilibHack)).arg(int(nativeOpenAL)).arg(int(nativeGLFW)).toUtf8());
+    for(auto &source: sources)
+    {
+        QFileInfo info(source);
+        if(!info.isFile())
+        {
+            return QString();
+        }
+        key.addData(QString("%1 %2 %3\n").arg(info.absoluteFilePath()).arg(info.size()).arg(info.lastModified().toMSecsSinceEpoch()).toUtf8());
+    }
+    return QString::fromLatin1(key.result().toHex());
+}
+
+bool moveFolderContents(const QString &from, const QString &to)
+{
+    QDir source(from);
+    QStringList files;
+    QDirIterator iter(from, QDir::Files | QDir::Hidden | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while(iter.hasNext())
+    {
+        files.append(iter.next());
+    }
+    for(auto &path: files)
+    {
+        auto target = FS::PathCombine(to, source.relativeFilePath(path));
+        if(!FS::ensureFilePathExists(target))
+        {
+            return false;
+        }
+        QFile::remove(target);
+        if(!QFile::rename(path, target))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void pruneCache(const QString &cacheDir, const QString &inUse)
+{
+    QDir dir(cacheDir);
+    auto now = QDateTime::currentMSecsSinceEpoch();
+    QList<QPair<qint64, QString>> folders;
+    for(auto &folder: dir.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot))
+    {
+        auto path = folder.absoluteFilePath();
+        if(folder.fileName().endsWith(".part"))
+        {
+            // somebody else may still be extracting into recent ones
+            if(now - folder.lastModified().toMSecsSinceEpoch() > stalePartAgeMs)
+            {
+                QDir(path).removeRecursively();
+            }
+            continue;
+        }
+        QFileInfo marker(markerPath(path));
+        auto lastUsed = marker.exists() ? marker.lastModified() : folder.lastModified();
+        folders.append(qMakePair(lastUsed.toMSecsSinceEpoch(), path));
+    }
+    // most recently used first
+    std::sort(folders.begin(), folders.end(), [](const QPair<qint64, QString> &a, const QPair<qint64, QString> &b)
+    {
+        return a.first > b.first;
+    });
+    for(int i = maxCachedFolders; i < folders.size(); i++)
+    {
+        auto &folder = folders[i];
+        if(folder.second == inUse || now - folder.first < pruneGraceMs)
+        {
+            continue;
+        }
+        removeCachedFolder(folder.second);
+    }
+}
+}
+
 void ExtractNatives::executeTask()
 {
     auto instance = m_parent->instance();
     std::shared_ptr<MinecraftInstance> minecraftInstance = std::dynamic_pointer_cast<MinecraftInstance>(instance);
+    minecraftInstance->setNativePath(QString());
     auto toExtract = minecraftInstance->getNativeJars();
     if(toExtract.isEmpty())
     {
@@ -97,21 +234,114 @@ void ExtractNatives::executeTask()
     auto outputPath  = minecraftInstance->getNativePath();
     auto javaVersion = minecraftInstance->getJavaVersion();
     bool jniHackEnabled = javaVersion.major() >= 8;
-    for(const auto &source: toExtract)
+
+    // extracted natives are shared by all launches and instances with the same native jars
+    auto cacheDir = APPLICATION->metacache()->getBasePath("natives");
+    auto key = nativesKey(toExtract, jniHackEnabled, nativeOpenAL, nativeGLFW);
+    if(key.isEmpty() || cacheDir.isEmpty() || !FS::ensureFolderPathExists(cacheDir))
+    {
+        for(const auto &source: toExtract)
+        {
+            if(!unzipNatives(source, outputPath, jniHackEnabled, nativeOpenAL, nativeGLFW))
+            {
+                const char *reason = QT_TR_NOOP("Couldn't extract native jar '%1' to destination '%2'");
+                emit logLine(QString(reason).arg(source, outputPath), MessageLevel::Fatal);
+                emitFailed(tr(reason).arg(source, outputPath));
+                return;
+            }
+        }
+        emitSucceeded();
+        return;
+    }
+
+    m_cachedPath = FS::PathCombine(cacheDir, key);
+    if(isComplete(m_cachedPath))
+    {
+        // keep it from being pruned as long as it is used
+        FS::updateTimestamp(markerPath(m_cachedPath));
+        minecraftInstance->setNativePath(m_cachedPath);
+        emitSucceeded();
+        return;
+    }
+
+    // every jar goes into its own folder in parallel, they get merged in order when all are done
+    m_sources = toExtract;
+    m_stagingPath = FS::PathCombine(cacheDir, key + "." + QUuid::createUuid().toString().mid(1, 8) + ".part");
+    QList<NativesJob> jobs;
+    for(int i = 0; i < toExtract.size(); i++)
     {
-        if(!unzipNatives(source, outputPath, jniHackEnabled, nativeOpenAL, nativeGLFW))
+        NativesJob job;
+        job.source = toExtract[i];
+        job.target = FS::PathCombine(m_stagingPath, QString::number(i));
+        job.applyJnilibHack = jniHackEnabled;
+        job.nativeOpenAL = nativeOpenAL;
+        job.nativeGLFW = nativeGLFW;
+        jobs.append(job);
+    }
+    connect(&m_extractWatcher, &QFutureWatcher<bool>::finished, this, &ExtractNatives::extractFinished, Qt::UniqueConnection);
+    m_extractWatcher.setFuture(QtConcurrent::mapped(jobs, runNativesJob));
+}
+
+void ExtractNatives::extractFinished()
+{
+    auto minecraftInstance = std::dynamic_pointer_cast<MinecraftInstance>(m_parent->instance());
+    auto results = m_extractWatcher.future().results();
+    auto fail = [&](const QString &source)
+    {
+        QDir(m_stagingPath).removeRecursively();
+        const char *reason = QT_TR_NOOP("Couldn't extract native jar '%1' to destination '%2'");
+        emit logLine(QString(reason).arg(source, m_cachedPath), MessageLevel::Fatal);
+        emitFailed(tr(reason).arg(source, m_cachedPath));
+    };
+    auto merged = FS::PathCombine(m_stagingPath, "merged");
+    for(int i = 0; i < m_sources.size(); i++)
+    {
+        if(i >= results.size() || !results[i])
         {
-            const char *reason = QT_TR_NOOP("Couldn't extract native jar '%1' to destination '%2'");
-            emit logLine(QString(reason).arg(source, outputPath), MessageLevel::Fatal);
-            emitFailed(tr(reason).arg(source, outputPath));
+            fail(m_sources[i]);
+            return;
         }
+        auto extracted = FS::PathCombine(m_stagingPath, QString::number(i));
+        if(!FS::ensureFolderPathExists(merged) || !moveFolderContents(extracted, merged))
+        {
+            fail(m_sources[i]);
+            return;
+        }
+    }
+    try
+    {
+        FS::write(markerPath(merged), QByteArray());
+    }
+    catch (const Exception &e)
+    {
+        emit logLine(e.cause(), MessageLevel::Fatal);
+        fail(m_sources.last());
+        return;
+    }
+    // a folder without the marker is left over from an interrupted extraction or removal
+    if(QFileInfo(m_cachedPath).exists() && !isComplete(m_cachedPath))
+    {
+        removeCachedFolder(m_cachedPath);
+    }
+    // another launch may have finished the same folder first, that one is just as good
+    if(!QDir().rename(merged, m_cachedPath) && !isComplete(m_cachedPath))
+    {
+        // the broken folder can't be replaced right now, use this extraction without caching it
+        emit logLine(tr("Couldn't cache the natives in %1, using them from %2").arg(m_cachedPath, merged), MessageLevel::Warning);
+        minecraftInstance->setNativePath(merged);
+        emitSucceeded();
+        return;
     }
+    QDir(m_stagingPath).removeRecursively();
+    pruneCache(QFileInfo(m_cachedPath).absolutePath(), m_cachedPath);
+    minecraftInstance->setNativePath(m_cachedPath);
     emitSucceeded();
 }
 
 void ExtractNatives::finalize()
 {
     auto instance = m_parent->instance();
+    std::dynamic_pointer_cast<MinecraftInstance>(instance)->setNativePath(QString());
     QString target_dir = FS::PathCombine(instance->instanceRoot(), "natives/");
     QDir dir(target_dir);
     dir.removeRecursively();
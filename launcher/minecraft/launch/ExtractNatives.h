@@ -17,6 +17,7 @@
 
 #include <launch/LaunchStep.h>
 #include <memory>
+#include <QFutureWatcher>
 #include "minecraft/auth/AuthSession.h"
 
 // FIXME: temporary wrapper for existing task.
@@ -33,6 +34,15 @@ public:
         return false;
     }
     void finalize() override;
+
+private slots:
+    void extractFinished();
+
+private:
+    QStringList m_sources;
+    QString m_stagingPath;
+    QString m_cachedPath;
+    QFutureWatcher<bool> m_extractWatcher;
 };
 
 
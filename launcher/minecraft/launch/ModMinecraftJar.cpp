@@ -20,6 +20,92 @@
 #include "FileSystem.h"
 #include "minecraft/MinecraftInstance.h"
 #include "minecraft/PackProfile.h"
+#include "Application.h"
+#include "net/HttpMetaCache.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDirIterator>
+#include <QUuid>
+
+namespace {
+// bump when createModdedJar starts producing different jars
+const int cacheFormatVersion = 3;
+// modded jars kept around, most recently used first
+const int maxCachedJars = 16;
+// staging files of launches that didn't finish, older than this, are removed
+const qint64 stalePartAgeMs = 24 * 60 * 60 * 1000;
+
+void addFileStamp(QCryptographicHash & key, const QFileInfo & info)
+{
+    key.addData(QString("%1 %2 %3\n").arg(info.absoluteFilePath()).arg(info.size()).arg(info.lastModified().toMSecsSinceEpoch()).toUtf8());
+}
+
+/*
+ * Everything that ends up in the modded jar: the source jar, and the enabled mods in order.
+ * Files are identified by absolute path, size and modification time, folders by those of everything in them.
+ * Reading the files would be more thorough, but this runs on every launch, on the UI thread. The path keeps copies
+ * with preserved modification times apart, at the price of not sharing jars between instances with identical mods.
+ */
+QString moddedJarKey(const QString & sourceJarPath, const QList<Mod> & mods)
+{
+    QCryptographicHash key(QCryptographicHash::Sha1);
+    key.addData(QString("modded jar %1\n").arg(cacheFormatVersion).toUtf8());
+    QFileInfo sourceJar(sourceJarPath);
+    if(!sourceJar.isFile())
+    {
+        return QString();
+    }
+    addFileStamp(key, sourceJar);
+    for(auto & mod: mods)
+    {
+        if(!mod.enabled())
+        {
+            continue;
+        }
+        auto file = mod.filename();
+        key.addData(QString("mod %1\n").arg(int(mod.type())).toUtf8());
+        addFileStamp(key, file);
+        if(mod.type() == Mod::MOD_FOLDER)
+        {
+            QStringList entries;
+            QDirIterator iter(file.absoluteFilePath(), QDir::Files | QDir::Hidden | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+            while(iter.hasNext())
+            {
+                iter.next();
+                auto info = iter.fileInfo();
+                entries.append(QString("%1 %2 %3").arg(info.absoluteFilePath()).arg(info.size()).arg(info.lastModified().toMSecsSinceEpoch()));
+            }
+            entries.sort();
+            key.addData(entries.join('\n').toUtf8());
+        }
+        else if(!file.isFile())
+        {
+            return QString();
+        }
+    }
+    return QString::fromLatin1(key.result().toHex());
+}
+
+void pruneCache(const QString & cacheDir)
+{
+    QDir dir(cacheDir);
+    // jars are touched whenever they are used
+    auto jars = dir.entryInfoList({"*.jar"}, QDir::Files, QDir::Time);
+    for(int i = maxCachedJars; i < jars.size(); i++)
+    {
+        QFile::remove(jars[i].absoluteFilePath());
+    }
+    auto now = QDateTime::currentMSecsSinceEpoch();
+    for(auto & part: dir.entryInfoList({"*.part"}, QDir::Files))
+    {
+        if(now - part.lastModified().toMSecsSinceEpoch() > stalePartAgeMs)
+        {
+            QFile::remove(part.absoluteFilePath());
+        }
+    }
+}
+}
 
 void ModMinecraftJar::executeTask()
 {
@@ -34,12 +120,14 @@ void ModMinecraftJar::executeTask()
     if(!FS::ensureFolderPathExists(m_inst->binRoot()))
     {
         emitFailed(tr("Couldn't create the bin folder for Minecraft.jar"));
+        return;
     }
 
     auto finalJarPath = QDir(m_inst->binRoot()).absoluteFilePath("minecraft.jar");
     if(!removeJar())
     {
         emitFailed(tr("Couldn't remove stale jar file: %1").arg(finalJarPath));
+        return;
     }
 
     // create temporary modded jar, if needed
@@ -52,9 +140,52 @@ void ModMinecraftJar::executeTask()
         QStringList jars, temp1, temp2, temp3, temp4;
         mainJar->getApplicableFiles(currentSystem, jars, temp1, temp2, temp3, m_inst->getLocalLibraryPath());
         auto sourceJarPath = jars[0];
-        if(!MMCZip::createModdedJar(sourceJarPath, finalJarPath, jarMods))
+
+        // the same inputs always give the same jar, so it can be shared by launches and instances
+        auto cacheDir = APPLICATION->metacache()->getBasePath("jarmods");
+        auto key = moddedJarKey(sourceJarPath, jarMods);
+        if(key.isEmpty() || cacheDir.isEmpty() || !FS::ensureFolderPathExists(cacheDir))
+        {
+            if(!MMCZip::createModdedJar(sourceJarPath, finalJarPath, jarMods))
+            {
+                emitFailed(tr("Failed to create the custom Minecraft jar file."));
+                return;
+            }
+            emitSucceeded();
+            return;
+        }
+        auto cachedJarPath = FS::PathCombine(cacheDir, key + ".jar");
+        if(QFileInfo::exists(cachedJarPath))
+        {
+            emit logLine(tr("Using cached custom Minecraft jar %1").arg(key), MessageLevel::Launcher);
+            // keep it from being pruned as long as it is used
+            FS::updateTimestamp(cachedJarPath);
+        }
+        else
+        {
+            // other launches may be building the same jar right now, each builds its own copy
+            auto tempJarPath = FS::PathCombine(cacheDir, key + "." + QUuid::createUuid().toString().mid(1, 8) + ".part");
+            if(!MMCZip::createModdedJar(sourceJarPath, tempJarPath, jarMods))
+            {
+                QFile::remove(tempJarPath);
+                emitFailed(tr("Failed to create the custom Minecraft jar file."));
+                return;
+            }
+            // if another launch got there first, its jar is just as good
+            if(!QFile::rename(tempJarPath, cachedJarPath))
+            {
+                QFile::remove(tempJarPath);
+                if(!QFileInfo::exists(cachedJarPath))
+                {
+                    emitFailed(tr("Failed to create the custom Minecraft jar file."));
+                    return;
+                }
+            }
+            pruneCache(cacheDir);
+        }
+        if(!FS::linkOrCopy(cachedJarPath, finalJarPath))
         {
-            emitFailed(tr("Failed to create the custom Minecraft jar file."));
+            emitFailed(tr("Couldn't place the custom Minecraft jar at %1").arg(finalJarPath));
             return;
         }
     }
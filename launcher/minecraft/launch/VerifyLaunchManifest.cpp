@@ -0,0 +1,51 @@
+#include "VerifyLaunchManifest.h"
+
+#include <launch/LaunchTask.h>
+#include <launch/steps/Update.h>
+#include <QtConcurrentRun>
+
+#include "minecraft/MinecraftInstance.h"
+#include "minecraft/LaunchManifest.h"
+#include "Application.h"
+
+void VerifyLaunchManifest::executeTask()
+{
+    auto instance = m_parent->instance();
+    auto minecraftInstance = std::dynamic_pointer_cast<MinecraftInstance>(instance);
+
+    // the launch manifest is only used while the metadata is refreshed once in a while
+    if(APPLICATION->settings()->get("MetadataRefreshInterval").toInt() <= 0)
+    {
+        emitSucceeded();
+        return;
+    }
+    m_manifest = LaunchManifest::load(LaunchManifest::path(minecraftInstance.get()));
+    if(!m_manifest)
+    {
+        emitSucceeded();
+        return;
+    }
+    auto manifest = m_manifest;
+    connect(&m_verifyWatcher, &QFutureWatcher<QString>::finished, this, &VerifyLaunchManifest::verifyFinished, Qt::UniqueConnection);
+    m_verifyWatcher.setFuture(QtConcurrent::run([manifest]()
+    {
+        return manifest->findChanges();
+    }));
+}
+
+void VerifyLaunchManifest::verifyFinished()
+{
+    auto changes = m_verifyWatcher.result();
+    if(!changes.isEmpty())
+    {
+        emit logLine(tr("The instance needs to be updated: %1\n").arg(changes), MessageLevel::Launcher);
+        m_manifest.reset();
+        emitSucceeded();
+        return;
+    }
+    emit logLine(tr("Nothing changed since the last update, loading the instance without going online.\n"), MessageLevel::Launcher);
+    auto minecraftInstance = std::dynamic_pointer_cast<MinecraftInstance>(m_parent->instance());
+    m_update->setUpdateTask(minecraftInstance->createLaunchUpdateTask(m_manifest));
+    m_manifest.reset();
+    emitSucceeded();
+}
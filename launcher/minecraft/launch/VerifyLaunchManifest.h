@@ -0,0 +1,35 @@
+#pragma once
+
+#include <launch/LaunchStep.h>
+#include <memory>
+#include <QFutureWatcher>
+
+class LaunchManifest;
+class Update;
+
+/**
+ * Checks if anything changed since the last online update of the instance, off the UI thread.
+ * If nothing did, the update step given to it only loads the instance from disk.
+ */
+class VerifyLaunchManifest: public LaunchStep
+{
+    Q_OBJECT
+public:
+    explicit VerifyLaunchManifest(LaunchTask *parent, Update *update) : LaunchStep(parent), m_update(update) {};
+    virtual ~VerifyLaunchManifest(){};
+
+    void executeTask() override;
+    bool canAbort() const override
+    {
+        return false;
+    }
+
+private slots:
+    void verifyFinished();
+
+private:
+    QFutureWatcher<QString> m_verifyWatcher;
+    std::shared_ptr<LaunchManifest> m_manifest;
+    // owned by the launch task, like this step
+    Update *m_update = nullptr;
+};
@@ -0,0 +1,184 @@
+#include "ModDetailsCache.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QCryptographicHash>
+#include <QFile>
+#include <QSaveFile>
+#include <QDebug>
+
+#include "FileSystem.h"
+
+namespace {
+const quint32 cacheMagic = 0x4D4D4443; // MMDC
+// bump when ModDetails or the parsers change, so everything gets parsed again
+const quint32 cacheVersion = 2;
+}
+
+ModDetailsCache::ModDetailsCache(const QString& path) : m_path(path)
+{
+}
+
+QString ModDetailsCache::key(const QString& fileName)
+{
+    // enabling and disabling a mod only renames it, the content stays the same
+    if(fileName.endsWith(".disabled"))
+    {
+        return fileName.left(fileName.size() - 9);
+    }
+    return fileName;
+}
+
+QByteArray ModDetailsCache::stamp(const QFileInfo& file)
+{
+    if(!file.isDir())
+    {
+        return QString("%1 %2").arg(file.size()).arg(file.lastModified().toMSecsSinceEpoch()).toUtf8();
+    }
+    // the folder itself doesn't change when something nested in it does
+    QDir folder(file.absoluteFilePath());
+    QStringList entries;
+    QDirIterator iter(folder.absolutePath(), QDir::Files | QDir::Hidden | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while(iter.hasNext())
+    {
+        iter.next();
+        auto info = iter.fileInfo();
+        entries.append(QString("%1 %2 %3").arg(folder.relativeFilePath(info.absoluteFilePath())).arg(info.size()).arg(info.lastModified().toMSecsSinceEpoch()));
+    }
+    entries.sort();
+    return QCryptographicHash::hash(entries.join('\n').toUtf8(), QCryptographicHash::Sha1);
+}
+
+bool ModDetailsCache::lookup(const QFileInfo& file, std::shared_ptr<ModDetails>& details)
+{
+    load();
+    auto iter = m_entries.constFind(key(file.fileName()));
+    if(iter == m_entries.constEnd())
+    {
+        return false;
+    }
+    if(iter->stamp != stamp(file))
+    {
+        return false;
+    }
+    details = iter->details;
+    return true;
+}
+
+void ModDetailsCache::insert(const QFileInfo& file, std::shared_ptr<ModDetails> details)
+{
+    load();
+    Entry entry;
+    entry.stamp = stamp(file);
+    entry.details = details;
+    m_entries.insert(key(file.fileName()), entry);
+    m_dirty = true;
+}
+
+void ModDetailsCache::retain(const QSet<QString>& fileNames)
+{
+    load();
+    QSet<QString> keys;
+    for(auto & fileName: fileNames)
+    {
+        keys.insert(key(fileName));
+    }
+    auto iter = m_entries.begin();
+    while(iter != m_entries.end())
+    {
+        if(!keys.contains(iter.key()))
+        {
+            iter = m_entries.erase(iter);
+            m_dirty = true;
+        }
+        else
+        {
+            iter++;
+        }
+    }
+}
+
+void ModDetailsCache::load()
+{
+    if(m_loaded)
+    {
+        return;
+    }
+    m_loaded = true;
+
+    QFile input(m_path);
+    if(!input.open(QIODevice::ReadOnly))
+    {
+        return;
+    }
+    QDataStream in(&input);
+    in.setVersion(QDataStream::Qt_5_0);
+    quint32 magic = 0, version = 0, count = 0;
+    in >> magic >> version >> count;
+    if(in.status() != QDataStream::Ok || magic != cacheMagic || version != cacheVersion)
+    {
+        return;
+    }
+    for(quint32 i = 0; i < count; i++)
+    {
+        QString fileName;
+        Entry entry;
+        bool hasDetails = false;
+        in >> fileName >> entry.stamp >> hasDetails;
+        if(hasDetails)
+        {
+            auto details = std::make_shared<ModDetails>();
+            in >> details->mod_id >> details->name >> details->version >> details->mcversion >> details->homeurl
+               >> details->updateurl >> details->description >> details->authors >> details->credits;
+            entry.details = details;
+        }
+        if(in.status() != QDataStream::Ok)
+        {
+            qWarning() << "Mod metadata cache" << m_path << "is damaged, ignoring the rest of it.";
+            m_dirty = true;
+            break;
+        }
+        m_entries.insert(fileName, entry);
+    }
+}
+
+void ModDetailsCache::save()
+{
+    if(!m_dirty)
+    {
+        return;
+    }
+    if(!FS::ensureFilePathExists(m_path))
+    {
+        qWarning() << "Couldn't create folder for" << m_path;
+        return;
+    }
+    QSaveFile output(m_path);
+    if(!output.open(QIODevice::WriteOnly))
+    {
+        qWarning() << "Couldn't open" << m_path << "for writing:" << output.errorString();
+        return;
+    }
+    QDataStream out(&output);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << cacheMagic << cacheVersion << quint32(m_entries.size());
+    for(auto iter = m_entries.constBegin(); iter != m_entries.constEnd(); iter++)
+    {
+        auto & entry = iter.value();
+        out << iter.key() << entry.stamp << bool(entry.details);
+        if(entry.details)
+        {
+            auto & details = *entry.details;
+            out << details.mod_id << details.name << details.version << details.mcversion << details.homeurl
+                << details.updateurl << details.description << details.authors << details.credits;
+        }
+    }
+    if(out.status() != QDataStream::Ok || !output.commit())
+    {
+        qWarning() << "Couldn't write mod metadata cache" << m_path;
+        return;
+    }
+    m_dirty = false;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QString>
+#include <QHash>
+#include <QSet>
+#include <QFileInfo>
+#include <memory>
+
+#include "ModDetails.h"
+
+/**
+ * Remembers what was parsed out of the mods in a folder, so unchanged mods don't have to be opened again.
+ *
+ * Entries are keyed by the file name (ignoring the .disabled suffix), size and modification time.
+ * Folder mods are checked by the paths, sizes and modification times of everything in them.
+ * The cache is read from disk the first time it's used.
+ */
+class ModDetailsCache
+{
+public:
+    explicit ModDetailsCache(const QString & path);
+
+    /// Returns true if the file was parsed before and didn't change since. details may be null for files without metadata.
+    bool lookup(const QFileInfo & file, std::shared_ptr<ModDetails> & details);
+    void insert(const QFileInfo & file, std::shared_ptr<ModDetails> details);
+
+    /// Forget all files not in the given set of file names
+    void retain(const QSet<QString> & fileNames);
+
+    bool isDirty() const
+    {
+        return m_dirty;
+    }
+    void save();
+
+private:
+    void load();
+    static QString key(const QString & fileName);
+    static QByteArray stamp(const QFileInfo & file);
+
+private:
+    struct Entry
+    {
+        QByteArray stamp;
+        std::shared_ptr<ModDetails> details;
+    };
+    QString m_path;
+    bool m_loaded = false;
+    bool m_dirty = false;
+    QHash<QString, Entry> m_entries;
+};
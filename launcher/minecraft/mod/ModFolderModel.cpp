@@ -23,16 +23,47 @@
 #include <QDebug>
 #include "ModFolderLoadTask.h"
 #include <QThreadPool>
+#include <QThread>
 #include <algorithm>
 #include "LocalModParseTask.h"
 
-ModFolderModel::ModFolderModel(const QString &dir) : QAbstractListModel(), m_dir(dir)
+namespace {
+// Parsing mods means opening lots of zips. It gets its own pool, so it can't starve everything else on the global one.
+QThreadPool & modParsePool()
+{
+    static QThreadPool pool;
+    pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() / 2));
+    return pool;
+}
+}
+
+ModFolderModel::ModFolderModel(const QString &dir, const QString &metadataCache) : QAbstractListModel(), m_dir(dir)
 {
     FS::ensureFolderPathExists(m_dir.absolutePath());
     m_dir.setFilter(QDir::Readable | QDir::NoDotAndDotDot | QDir::Files | QDir::Dirs);
     m_dir.setSorting(QDir::Name | QDir::IgnoreCase | QDir::LocaleAware);
     m_watcher = new QFileSystemWatcher(this);
     connect(m_watcher, SIGNAL(directoryChanged(QString)), this, SLOT(directoryChanged(QString)));
+    if(!metadataCache.isEmpty())
+    {
+        m_metadataCache.reset(new ModDetailsCache(metadataCache));
+        m_metadataCacheSaveTimer.setSingleShot(true);
+        m_metadataCacheSaveTimer.setInterval(2000);
+        connect(&m_metadataCacheSaveTimer, &QTimer::timeout, this, &ModFolderModel::saveMetadataCache);
+    }
+}
+
+ModFolderModel::~ModFolderModel()
+{
+    saveMetadataCache();
+}
+
+void ModFolderModel::saveMetadataCache()
+{
+    if(m_metadataCache)
+    {
+        m_metadataCache->save();
+    }
 }
 
 void ModFolderModel::startWatching()
@@ -158,6 +189,14 @@ void ModFolderModel::finishUpdate()
         }
     }
 
+    // forget about mods that are gone
+    if(m_metadataCache) {
+        m_metadataCache->retain(newSet);
+        if(m_metadataCache->isDirty()) {
+            m_metadataCacheSaveTimer.start();
+        }
+    }
+
     m_update.reset();
 
     emit updateFinished();
@@ -174,15 +213,20 @@ void ModFolderModel::resolveMod(Mod& m)
         return;
     }
 
+    std::shared_ptr<ModDetails> cachedDetails;
+    if(m_metadataCache && m_metadataCache->lookup(m.filename(), cachedDetails)) {
+        m.finishResolvingWithDetails(cachedDetails);
+        return;
+    }
+
     auto task = new LocalModParseTask(nextResolutionTicket, m.type(), m.filename());
     auto result = task->result();
     result->id = m.mmc_id();
     activeTickets.insert(nextResolutionTicket, result);
     m.setResolving(true, nextResolutionTicket);
     nextResolutionTicket++;
-    QThreadPool *threadPool = QThreadPool::globalInstance();
     connect(task, &LocalModParseTask::finished, this, &ModFolderModel::finishModParse);
-    threadPool->start(task);
+    modParsePool().start(task);
 }
 
 void ModFolderModel::finishModParse(int token)
@@ -196,6 +240,10 @@ void ModFolderModel::finishModParse(int token)
     int row = modsIndex[result->id];
     auto & mod = mods[row];
     mod.finishResolvingWithDetails(result->details);
+    if(m_metadataCache) {
+        m_metadataCache->insert(mod.filename(), result->details);
+        m_metadataCacheSaveTimer.start();
+    }
     emit dataChanged(index(row), index(row, columnCount(QModelIndex()) - 1));
 }
 
@@ -21,8 +21,11 @@
 #include <QString>
 #include <QDir>
 #include <QAbstractListModel>
+#include <QTimer>
+#include <memory>
 
 #include "Mod.h"
+#include "ModDetailsCache.h"
 
 #include "ModFolderLoadTask.h"
 #include "LocalModParseTask.h"
@@ -52,7 +55,9 @@ public:
         Enable,
         Toggle
     };
-    ModFolderModel(const QString &dir);
+    /// metadataCache is a file to remember parsed mod metadata in, if any
+    ModFolderModel(const QString &dir, const QString &metadataCache = QString());
+    virtual ~ModFolderModel();
 
     virtual QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
     virtual bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
@@ -126,6 +131,7 @@ slots:
     void directoryChanged(QString path);
     void finishUpdate();
     void finishModParse(int token);
+    void saveMetadataCache();
 
 signals:
     void updateFinished();
@@ -145,4 +151,6 @@ protected:
     QMap<int, LocalModParseTask::ResultPtr> activeTickets;
     int nextResolutionTicket = 0;
     QList<Mod> mods;
+    std::unique_ptr<ModDetailsCache> m_metadataCache;
+    QTimer m_metadataCacheSaveTimer;
 };
@@ -4,14 +4,58 @@
 #include "minecraft/PackProfile.h"
 
 #include "Application.h"
+#include "net/HttpMetaCache.h"
 
 LibrariesTask::LibrariesTask(MinecraftInstance * inst)
 {
     m_inst = inst;
+    connect(&m_revalidationWatcher, &QFutureWatcher<void>::finished, this, &LibrariesTask::revalidationFinished);
+}
+
+QList<LibraryPtr> LibrariesTask::sharedArtifactPool() const
+{
+    auto profile = m_inst->getPackProfile()->getProfile();
+    QList<LibraryPtr> libArtifactPool;
+    libArtifactPool.append(profile->getLibraries());
+    libArtifactPool.append(profile->getNativeLibraries());
+    libArtifactPool.append(profile->getMavenFiles());
+    libArtifactPool.append(profile->getMainJar());
+    return libArtifactPool;
 }
 
 void LibrariesTask::executeTask()
 {
+    // Check all the library files that changed on disk at once, in the background.
+    // Resolving the entries one by one would hash them one after another, on this thread.
+    setStatus(tr("Checking the library files..."));
+    QList<HttpMetaCache::Revalidation> revalidations;
+    for (auto lib : sharedArtifactPool())
+    {
+        if(!lib)
+        {
+            continue;
+        }
+        for(auto & artifact: lib->getCachedArtifacts(currentSystem))
+        {
+            HttpMetaCache::Revalidation revalidation;
+            revalidation.resource_path = artifact.first;
+            if(!artifact.second.isEmpty())
+            {
+                revalidation.algorithm = QCryptographicHash::Sha1;
+                revalidation.expected_hash = QByteArray::fromHex(artifact.second.toLatin1());
+            }
+            revalidations.append(revalidation);
+        }
+    }
+    m_revalidationWatcher.setFuture(APPLICATION->metacache()->revalidate("libraries", revalidations));
+}
+
+void LibrariesTask::revalidationFinished()
+{
+    if(m_aborted || !isRunning())
+    {
+        return;
+    }
     setStatus(tr("Getting the library files from Mojang..."));
     qDebug() << m_inst->name() << ": downloading libraries";
     MinecraftInstance *inst = (MinecraftInstance *)m_inst;
@@ -44,12 +88,7 @@ void LibrariesTask::executeTask()
     };
 
     QStringList failedLocalLibraries;
-    QList<LibraryPtr> libArtifactPool;
-    libArtifactPool.append(profile->getLibraries());
-    libArtifactPool.append(profile->getNativeLibraries());
-    libArtifactPool.append(profile->getMavenFiles());
-    libArtifactPool.append(profile->getMainJar());
-    processArtifactPool(libArtifactPool, failedLocalLibraries, inst->getLocalLibraryPath());
+    processArtifactPool(sharedArtifactPool(), failedLocalLibraries, inst->getLocalLibraryPath());
 
     QStringList failedLocalJarMods;
     processArtifactPool(profile->getJarMods(), failedLocalJarMods, inst->jarModsDir());
@@ -84,9 +123,12 @@ bool LibrariesTask::abort()
     {
         return downloadJob->abort();
     }
-    else
+    // still checking the files, the downloads haven't started yet
+    m_aborted = true;
+    m_revalidationWatcher.cancel();
+    if(isRunning())
     {
-        qWarning() << "Prematurely aborted LibrariesTask";
+        emitAborted();
     }
     return true;
 }
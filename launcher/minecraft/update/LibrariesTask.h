@@ -1,6 +1,10 @@
 #pragma once
 #include "tasks/Task.h"
 #include "net/NetJob.h"
+#include "minecraft/Library.h"
+
+#include <QFutureWatcher>
+
 class MinecraftInstance;
 
 class LibrariesTask : public Task
@@ -15,12 +19,18 @@ public:
     bool canAbort() const override;
 
 private slots:
+    void revalidationFinished();
     void jarlibFailed(QString reason);
 
 public slots:
     bool abort() override;
 
+private:
+    QList<LibraryPtr> sharedArtifactPool() const;
+
 private:
     MinecraftInstance *m_inst;
     NetJob::Ptr downloadJob;
+    QFutureWatcher<void> m_revalidationWatcher;
+    bool m_aborted = false;
 };
@@ -0,0 +1,59 @@
+#include "MetadataRefreshTask.h"
+
+#include <QDebug>
+
+#include "minecraft/LaunchManifest.h"
+#include "meta/Index.h"
+#include "meta/Version.h"
+#include "Application.h"
+
+MetadataRefreshTask::MetadataRefreshTask(std::shared_ptr<LaunchManifest> manifest) : Task(), m_manifest(manifest)
+{
+}
+
+void MetadataRefreshTask::executeTask()
+{
+    setStatus(tr("Checking for metadata updates..."));
+    auto index = APPLICATION->metadataIndex();
+    for(auto & component: m_manifest->components())
+    {
+        auto version = index->get(component.first, component.second);
+        version->load(Net::Mode::Online);
+        auto task = version->getCurrentTask();
+        if(task)
+        {
+            m_loads.append(task);
+            connect(task.get(), &Task::finished, this, &MetadataRefreshTask::partFinished);
+        }
+    }
+    if(m_loads.isEmpty())
+    {
+        emitSucceeded();
+    }
+}
+
+void MetadataRefreshTask::partFinished()
+{
+    auto task = qobject_cast<Task *>(sender());
+    m_failed |= !task || !task->wasSuccessful();
+    m_finished++;
+    if(m_finished < m_loads.size())
+    {
+        return;
+    }
+    m_loads.clear();
+    if(m_failed)
+    {
+        emitFailed(tr("Some of the metadata couldn't be checked for updates."));
+        return;
+    }
+    if(m_manifest->markRefreshed())
+    {
+        qDebug() << "Component metadata didn't change, the launch manifest stays valid.";
+    }
+    else
+    {
+        qDebug() << "Component metadata changed, the next launch will update the instance.";
+    }
+    emitSucceeded();
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include "tasks/Task.h"
+#include <memory>
+
+class LaunchManifest;
+
+/**
+ * Checks the metadata of the components in a launch manifest for updates, while the game runs.
+ *
+ * If any metadata changed, the manifest no longer matches and the next launch does a full online update.
+ * Otherwise, the manifest is marked as refreshed.
+ */
+class MetadataRefreshTask : public Task
+{
+    Q_OBJECT
+public:
+    explicit MetadataRefreshTask(std::shared_ptr<LaunchManifest> manifest);
+    virtual ~MetadataRefreshTask() {};
+
+    void executeTask() override;
+
+private slots:
+    void partFinished();
+
+private:
+    std::shared_ptr<LaunchManifest> m_manifest;
+    QList<Task::Ptr> m_loads;
+    int m_finished = 0;
+    bool m_failed = false;
+};
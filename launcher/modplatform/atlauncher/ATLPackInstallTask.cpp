@@ -733,18 +733,10 @@ bool PackInstallTask::extractMods(
         auto &from = iter.key();
         auto &to = iter.value();
 
-        // If the file already exists, assume the mod is the correct copy - and remove
+        // If the file already exists, assume the mod is the correct copy - and replace
         // the copy from the Configs.zip
-        QFileInfo fileInfo(to);
-        if (fileInfo.exists()) {
-            if (!QFile::remove(to)) {
-                qWarning() << "Failed to delete" << to;
-                return false;
-            }
-        }
-
-        FS::copy fileCopyOperation(from, to);
-        if(!fileCopyOperation()) {
+        // The cached download is only ever replaced, never modified, so the instance can share it.
+        if(!FS::linkOrCopy(from, to)) {
             qWarning() << "Failed to copy" << from << "to" << to;
             return false;
         }
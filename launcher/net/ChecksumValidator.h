@@ -10,7 +10,7 @@ class ChecksumValidator: public Validator
 {
 public: /* con/des */
     ChecksumValidator(QCryptographicHash::Algorithm algorithm, QByteArray expected = QByteArray())
-        :m_checksum(algorithm), m_expected(expected)
+        :m_checksum(algorithm), m_algorithm(algorithm), m_expected(expected)
     {
     };
     virtual ~ChecksumValidator() {};
@@ -47,9 +47,18 @@ public: /* methods */
     {
         m_expected = expected;
     }
+    QByteArray expected() const
+    {
+        return m_expected;
+    }
+    QCryptographicHash::Algorithm algorithm() const
+    {
+        return m_algorithm;
+    }
 
 private: /* data */
     QCryptographicHash m_checksum;
+    QCryptographicHash::Algorithm m_algorithm;
     QByteArray m_expected;
 };
 }
\ No newline at end of file
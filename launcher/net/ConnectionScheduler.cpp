@@ -0,0 +1,217 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ConnectionScheduler.h"
+
+#include <QDebug>
+
+namespace {
+// all hosts and all jobs together
+const int globalLimit = 32;
+
+// per host. QNetworkAccessManager keeps 6 HTTP/1.1 connections per host, anything above that
+// queues inside Qt, shows up as time to first byte and gets backed off by the latency check below.
+const int initialHostLimit = 6;
+const int minHostLimit = 1;
+const int maxHostLimit = 16;
+
+// latency is considered inflated when the moving average is this many times the best one...
+const int latencyInflationFactor = 4;
+// ... plus this much slack, so very fast hosts don't trip over jitter
+const int latencySlackMs = 100;
+
+// smaller responses are over before the transfer rate means anything
+const qint64 minThroughputBytes = 64 * 1024;
+// one more connection has to add at least this much to the throughput of the host to be worth it
+const double throughputGainFactor = 1.05;
+}
+
+namespace Net {
+
+ConnectionScheduler::ConnectionScheduler(QObject *parent) : QObject(parent)
+{
+}
+
+ConnectionScheduler & ConnectionScheduler::global()
+{
+    static ConnectionScheduler scheduler;
+    return scheduler;
+}
+
+ConnectionScheduler::HostState & ConnectionScheduler::hostState(const QString& host)
+{
+    auto iter = m_hosts.find(host);
+    if(iter == m_hosts.end())
+    {
+        HostState state;
+        state.limit = initialHostLimit;
+        iter = m_hosts.insert(host, state);
+    }
+    return *iter;
+}
+
+int ConnectionScheduler::hostLimit(const QString& host) const
+{
+    auto iter = m_hosts.constFind(host);
+    if(iter == m_hosts.constEnd())
+    {
+        return initialHostLimit;
+    }
+    return iter->limit;
+}
+
+double ConnectionScheduler::hostThroughput(const QString& host) const
+{
+    auto iter = m_hosts.constFind(host);
+    if(iter == m_hosts.constEnd())
+    {
+        return 0.0;
+    }
+    return iter->throughputAverage;
+}
+
+bool ConnectionScheduler::hasFreeSlots() const
+{
+    return m_inFlight < globalLimit;
+}
+
+bool ConnectionScheduler::tryAcquire(const QString& host)
+{
+    if(m_inFlight >= globalLimit)
+    {
+        return false;
+    }
+    auto &state = hostState(host);
+    if(state.inFlight >= state.limit)
+    {
+        return false;
+    }
+    state.inFlight++;
+    m_inFlight++;
+    return true;
+}
+
+void ConnectionScheduler::releaseUnmeasured(const QString& host)
+{
+    auto &state = hostState(host);
+    if(state.inFlight > 0)
+    {
+        state.inFlight--;
+        m_inFlight--;
+    }
+    scheduleNotify();
+}
+
+void ConnectionScheduler::release(const QString& host, const Measurement& measurement)
+{
+    auto &state = hostState(host);
+    if(state.inFlight > 0)
+    {
+        state.inFlight--;
+        m_inFlight--;
+    }
+
+    if(!measurement.success && !measurement.overloaded)
+    {
+        // missing files, checksum mismatches and the like say nothing about the load on the host
+        scheduleNotify();
+        return;
+    }
+    if(!measurement.success)
+    {
+        // multiplicative decrease
+        int newLimit = qMax(minHostLimit, state.limit / 2);
+        if(newLimit != state.limit)
+        {
+            qDebug() << "Host" << host << "looks overloaded, lowering concurrency to" << newLimit;
+        }
+        state.limit = newLimit;
+        state.successesInWindow = 0;
+        scheduleNotify();
+        return;
+    }
+
+    auto latency = measurement.firstByteMs;
+    if(state.bestLatency < 0 || latency < state.bestLatency)
+    {
+        state.bestLatency = latency;
+    }
+    if(state.latencyAverage <= 0.0)
+    {
+        state.latencyAverage = latency;
+    }
+    else
+    {
+        state.latencyAverage += (latency - state.latencyAverage) / 8.0;
+    }
+    if(measurement.bytes >= minThroughputBytes)
+    {
+        double throughput = measurement.bytes * 1000.0 / qMax<qint64>(1, measurement.transferMs);
+        if(state.throughputAverage <= 0.0)
+        {
+            state.throughputAverage = throughput;
+        }
+        else
+        {
+            state.throughputAverage += (throughput - state.throughputAverage) / 8.0;
+        }
+    }
+
+    state.successesInWindow++;
+    if(state.successesInWindow < state.limit)
+    {
+        scheduleNotify();
+        return;
+    }
+    // one full window of requests went through, adjust
+    state.successesInWindow = 0;
+    bool inflated = state.latencyAverage > state.bestLatency * latencyInflationFactor + latencySlackMs;
+    // connections sharing a saturated link only split the same bandwidth between them
+    double aggregate = state.throughputAverage * state.limit;
+    bool bandwidthBound = state.increasedLastWindow && state.aggregateBeforeIncrease > 0.0
+        && aggregate < state.aggregateBeforeIncrease * throughputGainFactor;
+    state.increasedLastWindow = false;
+    if(inflated && state.limit > minHostLimit)
+    {
+        state.limit--;
+        qDebug() << "Latency to" << host << "is rising, lowering concurrency to" << state.limit;
+    }
+    else if(!inflated && !bandwidthBound && state.limit < maxHostLimit)
+    {
+        state.aggregateBeforeIncrease = aggregate;
+        state.increasedLastWindow = true;
+        // additive increase
+        state.limit++;
+    }
+    scheduleNotify();
+}
+
+void ConnectionScheduler::scheduleNotify()
+{
+    if(m_notifyPending)
+    {
+        return;
+    }
+    m_notifyPending = true;
+    QMetaObject::invokeMethod(this, "notifySlotsAvailable", Qt::QueuedConnection);
+}
+
+void ConnectionScheduler::notifySlotsAvailable()
+{
+    m_notifyPending = false;
+    emit slotsAvailable();
+}
+
+}
@@ -0,0 +1,98 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QHash>
+#include <QString>
+
+namespace Net {
+
+/**
+ * Decides how many requests may be in flight at once, shared by all running NetJobs.
+ *
+ * Every host gets its own concurrency limit, adjusted AIMD-style from what the host does:
+ * a full window of successful requests raises the limit by one, and a failure that looks like
+ * overload (connection errors, timeouts, 429 and 5xx) halves it. Time to first byte climbing far
+ * above the best observed one (requests queueing up somewhere) takes one slot away. Transfer
+ * throughput is tracked separately: once more connections stop adding to it, the limit stays put.
+ * All hosts together are capped by a global budget.
+ */
+class ConnectionScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    static ConnectionScheduler & global();
+
+    /// Try to take a slot for a request to the given host. Returns false if the host or global budget is exhausted.
+    bool tryAcquire(const QString & host);
+
+    /// How a request went, for release()
+    struct Measurement
+    {
+        bool success = false;
+        /// the failure looks like the host is overloaded, see NetAction::failedFromOverload()
+        bool overloaded = false;
+        /// from sending the request to the first byte of the response
+        qint64 firstByteMs = 0;
+        /// from the first byte to the end of the response
+        qint64 transferMs = 0;
+        qint64 bytes = 0;
+    };
+
+    /// Give back a slot taken by tryAcquire and report how the request went.
+    void release(const QString & host, const Measurement & measurement);
+
+    /// Give back a slot without using the request for adaptation (cache hits, aborts).
+    void releaseUnmeasured(const QString & host);
+
+    int hostLimit(const QString & host) const;
+    /// Average transfer rate of single requests to the host in bytes per second, 0 if unknown
+    double hostThroughput(const QString & host) const;
+    bool hasFreeSlots() const;
+
+signals:
+    /// Emitted (queued and coalesced) when slots were released and waiting jobs should try again.
+    void slotsAvailable();
+
+private slots:
+    void notifySlotsAvailable();
+
+private:
+    explicit ConnectionScheduler(QObject *parent = nullptr);
+    void scheduleNotify();
+
+    struct HostState
+    {
+        int limit;
+        int inFlight = 0;
+        int successesInWindow = 0;
+        double latencyAverage = 0.0;
+        qint64 bestLatency = -1;
+        // bytes per second of single requests
+        double throughputAverage = 0.0;
+        // throughputAverage times the limit when the limit was last raised
+        double aggregateBeforeIncrease = 0.0;
+        bool increasedLastWindow = false;
+    };
+    HostState & hostState(const QString & host);
+
+    QHash<QString, HostState> m_hosts;
+    int m_inFlight = 0;
+    bool m_notifyPending = false;
+};
+
+}
@@ -77,6 +77,8 @@ void Download::startImpl()
         return;
     }
     QNetworkRequest request(m_url);
+    m_error = QNetworkReply::NoError;
+    m_httpStatus = 0;
     m_status = m_sink->init(request);
     switch(m_status)
     {
@@ -117,6 +119,7 @@ void Download::downloadProgress(qint64 bytesReceived, qint64 bytesTotal)
 
 void Download::downloadError(QNetworkReply::NetworkError error)
 {
+    recordError(error);
     if(error == QNetworkReply::OperationCanceledError)
     {
         qCritical() << "Aborted " << m_url.toString();
@@ -2,6 +2,7 @@
 #include <QFile>
 #include <QFileInfo>
 #include "FileSystem.h"
+#include "ObjectStore.h"
 
 namespace Net {
 
@@ -23,6 +24,13 @@ JobStatus FileSink::init(QNetworkRequest& request)
     {
         return result;
     }
+    // if we know what we are getting and already have it, there's no need to download it
+    auto checksum = expectedChecksum();
+    if(checksum && ObjectStore::global().fetch(checksum->algorithm(), checksum->expected(), m_filename))
+    {
+        qDebug() << "Object store hit for" << m_filename;
+        return finalizeFromObjectStore();
+    }
     // create a new save file and open it for writing
     if (!FS::ensureFilePathExists(m_filename))
     {
@@ -94,6 +102,12 @@ JobStatus FileSink::finalize(QNetworkReply& reply)
             m_output_file->cancelWriting();
             return Job_Failed;
         }
+        // the validators passed, so the file has the expected checksum. share it.
+        auto checksum = expectedChecksum();
+        if(checksum)
+        {
+            ObjectStore::global().store(checksum->algorithm(), checksum->expected(), m_filename, writtenMd5());
+        }
     }
     // then get rid of the save file
     m_output_file.reset();
@@ -106,6 +120,37 @@ JobStatus FileSink::finalizeCache(QNetworkReply &)
     return Job_Finished;
 }
 
+JobStatus FileSink::finalizeFromObjectStore()
+{
+    return Job_Finished;
+}
+
+QByteArray FileSink::writtenMd5()
+{
+    for(auto & validator: validators)
+    {
+        auto checksum = dynamic_cast<ChecksumValidator *>(validator.get());
+        if(checksum && checksum->algorithm() == QCryptographicHash::Md5)
+        {
+            return checksum->hash();
+        }
+    }
+    return QByteArray();
+}
+
+ChecksumValidator * FileSink::expectedChecksum()
+{
+    for(auto & validator: validators)
+    {
+        auto checksum = dynamic_cast<ChecksumValidator *>(validator.get());
+        if(checksum && !checksum->expected().isEmpty())
+        {
+            return checksum;
+        }
+    }
+    return nullptr;
+}
+
 bool FileSink::hasLocalData()
 {
     QFileInfo info(m_filename);
@@ -1,5 +1,6 @@
 #pragma once
 #include "Sink.h"
+#include "ChecksumValidator.h"
 #include <QSaveFile>
 
 namespace Net {
@@ -19,6 +20,13 @@ public: /* methods */
 protected: /* methods */
     virtual JobStatus initCache(QNetworkRequest &);
     virtual JobStatus finalizeCache(QNetworkReply &reply);
+    // called when the file was taken from the object store instead of the network
+    virtual JobStatus finalizeFromObjectStore();
+    ChecksumValidator * expectedChecksum();
+
+private: /* methods */
+    // raw MD5 of what was written, if one of the validators computed it
+    QByteArray writtenMd5();
 
 protected: /* data */
     QString m_filename;
@@ -26,6 +26,58 @@
 #include <QJsonDocument>
 #include <QJsonArray>
 #include <QJsonObject>
+#include <QDataStream>
+#include <QSaveFile>
+#include <QDir>
+#include <QThread>
+#include <QFutureInterface>
+#include <QtConcurrentRun>
+
+/*
+ * The index is stored as one file per base in <index file>.d/<base>.idx, loaded the first time the base is used.
+ *
+ * Each file starts with a header (magic, version) followed by a journal of records, either putting an entry
+ * or removing one. Changes are appended to the journal, and when it gets too long compared to the number of live
+ * entries, it is rewritten from scratch.
+ *
+ * The old single JSON file (version 1) is converted when no index directory exists yet.
+ */
+namespace {
+const quint32 indexMagic = 0x4D4D4343; // MMCC
+const quint32 indexVersion = 2;
+const QDataStream::Version streamVersion = QDataStream::Qt_5_0;
+
+enum RecordType : quint8
+{
+    PutRecord = 1,
+    RemoveRecord = 2
+};
+
+// rewrite the journal when it has this many more records than live entries
+const int compactionSlack = 1000;
+
+// files are hashed in chunks of this size, never read whole
+const qint64 hashChunkSize = 64 * 1024;
+
+QByteArray hashFile(const QString &path, QCryptographicHash::Algorithm algorithm)
+{
+    QFile input(path);
+    if (!input.open(QIODevice::ReadOnly))
+        return QByteArray();
+    QCryptographicHash hash(algorithm);
+    QByteArray buffer(int(hashChunkSize), Qt::Uninitialized);
+    while (true)
+    {
+        qint64 read = input.read(buffer.data(), hashChunkSize);
+        if (read < 0)
+            return QByteArray();
+        if (read == 0)
+            break;
+        hash.addData(buffer.constData(), int(read));
+    }
+    return hash.result();
+}
+}
 
 QString MetaEntry::getFullPath()
 {
@@ -33,22 +85,42 @@ QString MetaEntry::getFullPath()
     return FS::PathCombine(basePath, relativePath);
 }
 
+bool MetaEntry::isFresh(qint64 defaultMaxAge) const
+{
+    if(stale || !confirmed_timestamp)
+    {
+        return false;
+    }
+    auto maxAge = max_age >= 0 ? max_age : defaultMaxAge;
+    return QDateTime::currentMSecsSinceEpoch() - confirmed_timestamp < maxAge;
+}
+
 HttpMetaCache::HttpMetaCache(QString path) : QObject()
 {
     m_index_file = path;
+    if(!path.isNull())
+    {
+        m_index_dir = path + ".d";
+    }
     saveBatchingTimer.setSingleShot(true);
     saveBatchingTimer.setTimerType(Qt::VeryCoarseTimer);
     connect(&saveBatchingTimer, SIGNAL(timeout()), SLOT(SaveNow()));
+    // hashing is disk bound, more threads than this only make the disk seek more
+    m_hashPool.setMaxThreadCount(qBound(1, QThread::idealThreadCount() / 2, 4));
 }
 
 HttpMetaCache::~HttpMetaCache()
 {
     saveBatchingTimer.stop();
+    m_hashPool.waitForDone();
+    applyRevalidations();
     SaveNow();
 }
 
 MetaEntryPtr HttpMetaCache::getEntry(QString base, QString resource_path)
 {
+    // anything checked in the background takes effect before we answer
+    applyRevalidations();
     // no base. no base path. can't store
     if (!m_entries.contains(base))
     {
@@ -56,6 +128,7 @@ MetaEntryPtr HttpMetaCache::getEntry(QString base, QString resource_path)
         return MetaEntryPtr();
     }
     EntryMap &map = m_entries[base];
+    ensureLoaded(base, map);
     if (map.entry_list.contains(resource_path))
     {
         return map.entry_list[resource_path];
@@ -81,6 +154,7 @@ MetaEntryPtr HttpMetaCache::resolveEntry(QString base, QString resource_path, QS
     {
         // if the file doesn't exist, we disown the entry
         selected_base.entry_list.remove(resource_path);
+        markDirty(selected_base, resource_path);
         return staleEntry(base, resource_path);
     }
 
@@ -88,26 +162,19 @@ MetaEntryPtr HttpMetaCache::resolveEntry(QString base, QString resource_path, QS
     {
         // if the etag doesn't match expected, we disown the entry
         selected_base.entry_list.remove(resource_path);
+        markDirty(selected_base, resource_path);
         return staleEntry(base, resource_path);
     }
 
-    // if the file changed, check md5sum
+    // if the file changed, it has to be checked. Hashing it here would block the caller, so it is checked in the
+    // background for the next time and the caller gets it again now. Use revalidate() first to avoid that.
     qint64 file_last_changed = finfo.lastModified().toUTC().toMSecsSinceEpoch();
     if (file_last_changed != entry->local_changed_timestamp)
     {
-        QFile input(real_path);
-        input.open(QIODevice::ReadOnly);
-        QString md5sum = QCryptographicHash::hash(input.readAll(), QCryptographicHash::Md5)
-                             .toHex()
-                             .constData();
-        if (entry->md5sum != md5sum)
-        {
-            selected_base.entry_list.remove(resource_path);
-            return staleEntry(base, resource_path);
-        }
-        // md5sums matched... keep entry and save the new state to file
-        entry->local_changed_timestamp = file_last_changed;
-        SaveEventually();
+        HttpMetaCache::Revalidation revalidation;
+        revalidation.resource_path = resource_path;
+        revalidate(base, {revalidation});
+        return staleEntry(base, resource_path);
     }
 
     // entry passed all the checks we cared about.
@@ -115,6 +182,112 @@ MetaEntryPtr HttpMetaCache::resolveEntry(QString base, QString resource_path, QS
     return entry;
 }
 
+QFuture<void> HttpMetaCache::revalidate(QString base, const QList<Revalidation> &revalidations)
+{
+    auto futureInterface = std::make_shared<QFutureInterface<void>>();
+    futureInterface->reportStarted();
+    auto future = futureInterface->future();
+
+    if (!m_entries.contains(base))
+    {
+        futureInterface->reportFinished();
+        return future;
+    }
+    auto &map = m_entries[base];
+    ensureLoaded(base, map);
+
+    struct Work
+    {
+        MetaEntryPtr entry;
+        QString real_path;
+        QString md5sum;
+        qint64 local_changed_timestamp;
+        QCryptographicHash::Algorithm algorithm;
+        QByteArray expected_hash;
+    };
+    QList<Work> work;
+    for (auto &revalidation : revalidations)
+    {
+        auto entry = map.entry_list.value(revalidation.resource_path);
+        // missing entries and files are cheap to deal with, resolveEntry can do that
+        if (!entry || entry->stale)
+            continue;
+        QString real_path = FS::PathCombine(map.base_path, revalidation.resource_path);
+        QFileInfo finfo(real_path);
+        if (!finfo.isFile())
+            continue;
+        qint64 file_last_changed = finfo.lastModified().toUTC().toMSecsSinceEpoch();
+        if (file_last_changed == entry->local_changed_timestamp)
+            continue;
+        work.append({entry, real_path, entry->md5sum, file_last_changed, revalidation.algorithm, revalidation.expected_hash});
+    }
+
+    if (work.isEmpty())
+    {
+        futureInterface->reportFinished();
+        return future;
+    }
+
+    qDebug() << "Revalidating" << work.size() << "changed files in" << base;
+    auto remaining = std::make_shared<QAtomicInt>(work.size());
+    for (auto &item : work)
+    {
+        QtConcurrent::run(&m_hashPool, [this, base, item, futureInterface, remaining]()
+        {
+            RevalidationResult result;
+            result.base = base;
+            result.entry = item.entry;
+            result.local_changed_timestamp = item.local_changed_timestamp;
+            if (!item.expected_hash.isEmpty())
+            {
+                result.valid = hashFile(item.real_path, item.algorithm) == item.expected_hash;
+            }
+            else
+            {
+                result.valid = QString(hashFile(item.real_path, QCryptographicHash::Md5).toHex().constData()) == item.md5sum;
+            }
+            {
+                QMutexLocker locker(&m_revalidatedLock);
+                m_revalidated.append(result);
+            }
+            QMetaObject::invokeMethod(this, "applyRevalidations", Qt::QueuedConnection);
+            if (!remaining->deref())
+            {
+                futureInterface->reportFinished();
+            }
+        });
+    }
+    return future;
+}
+
+void HttpMetaCache::applyRevalidations()
+{
+    QList<RevalidationResult> results;
+    {
+        QMutexLocker locker(&m_revalidatedLock);
+        results.swap(m_revalidated);
+    }
+    for (auto &result : results)
+    {
+        if (!m_entries.contains(result.base))
+            continue;
+        auto &map = m_entries[result.base];
+        auto path = result.entry->relativePath;
+        // the entry was replaced while we were looking at it, the new one knows better
+        if (map.entry_list.value(path) != result.entry)
+            continue;
+        if (result.valid)
+        {
+            result.entry->local_changed_timestamp = result.local_changed_timestamp;
+        }
+        else
+        {
+            map.entry_list.remove(path);
+        }
+        markDirty(map, path);
+    }
+}
+
 bool HttpMetaCache::updateEntry(MetaEntryPtr stale_entry)
 {
     if (!m_entries.contains(stale_entry->baseId))
@@ -128,8 +301,10 @@ bool HttpMetaCache::updateEntry(MetaEntryPtr stale_entry)
         qCritical() << "Cannot add stale entry: " << stale_entry->getFullPath().toLocal8Bit();
         return false;
     }
-    m_entries[stale_entry->baseId].entry_list[stale_entry->relativePath] = stale_entry;
-    SaveEventually();
+    auto &map = m_entries[stale_entry->baseId];
+    ensureLoaded(stale_entry->baseId, map);
+    map.entry_list[stale_entry->relativePath] = stale_entry;
+    markDirty(map, stale_entry->relativePath);
     return true;
 }
 
@@ -138,7 +313,10 @@ bool HttpMetaCache::evictEntry(MetaEntryPtr entry)
     if(entry)
     {
         entry->stale = true;
-        SaveEventually();
+        if(m_entries.contains(entry->baseId))
+        {
+            markDirty(m_entries[entry->baseId], entry->relativePath);
+        }
         return true;
     }
     return false;
@@ -154,6 +332,12 @@ MetaEntryPtr HttpMetaCache::staleEntry(QString base, QString resource_path)
     return MetaEntryPtr(foo);
 }
 
+void HttpMetaCache::markDirty(EntryMap &map, const QString &resource_path)
+{
+    map.dirty.insert(resource_path);
+    SaveEventually();
+}
+
 void HttpMetaCache::addBase(QString base, QString base_root)
 {
     // TODO: report error
@@ -174,35 +358,129 @@ QString HttpMetaCache::getBasePath(QString base)
     return QString();
 }
 
+QString HttpMetaCache::baseIndexPath(const QString &base) const
+{
+    return FS::PathCombine(m_index_dir, base + ".idx");
+}
+
+void HttpMetaCache::ensureLoaded(const QString &base, EntryMap &map)
+{
+    if(map.loaded)
+        return;
+    map.loaded = true;
+    if(m_index_dir.isNull())
+        return;
+    loadBase(base, map);
+}
+
 void HttpMetaCache::Load()
 {
     if(m_index_file.isNull())
         return;
 
-    QFile index(m_index_file);
+    // bases are loaded lazily, all we have to do here is convert the old index if there is one
+    if(!QDir(m_index_dir).exists())
+    {
+        if(migrateFromJson())
+        {
+            SaveNow();
+        }
+    }
+}
+
+void HttpMetaCache::loadBase(const QString &base, EntryMap &map)
+{
+    QFile index(baseIndexPath(base));
     if (!index.open(QIODevice::ReadOnly))
         return;
 
+    QDataStream in(&index);
+    in.setVersion(streamVersion);
+    quint32 magic = 0, version = 0;
+    in >> magic >> version;
+    if(in.status() != QDataStream::Ok || magic != indexMagic || version != indexVersion)
+    {
+        qWarning() << "Ignoring unknown meta cache index" << index.fileName();
+        map.needsCompaction = true;
+        SaveEventually();
+        return;
+    }
+    while(!in.atEnd())
+    {
+        quint8 type = 0;
+        QString path;
+        in >> type >> path;
+        if(type == PutRecord)
+        {
+            QString md5sum, etag, remote_changed_timestamp;
+            qint64 local_changed_timestamp = 0;
+            in >> md5sum >> etag >> local_changed_timestamp >> remote_changed_timestamp;
+            if(in.status() != QDataStream::Ok)
+                break;
+            auto foo = new MetaEntry();
+            foo->baseId = base;
+            foo->relativePath = path;
+            foo->md5sum = md5sum;
+            foo->etag = etag;
+            foo->local_changed_timestamp = local_changed_timestamp;
+            foo->remote_changed_timestamp = remote_changed_timestamp;
+            // presumed innocent until closer examination
+            foo->stale = false;
+            map.entry_list[path] = MetaEntryPtr(foo);
+        }
+        else if(type == RemoveRecord && in.status() == QDataStream::Ok)
+        {
+            map.entry_list.remove(path);
+        }
+        else
+        {
+            in.setStatus(QDataStream::ReadCorruptData);
+            break;
+        }
+        map.records++;
+    }
+    if(in.status() != QDataStream::Ok)
+    {
+        // probably a write that didn't finish. keep what we got, but don't append after the garbage.
+        qWarning() << "Meta cache index" << index.fileName() << "is damaged, it will be rewritten.";
+        map.needsCompaction = true;
+        SaveEventually();
+    }
+}
+
+bool HttpMetaCache::migrateFromJson()
+{
+    QFile index(m_index_file);
+    if (!index.open(QIODevice::ReadOnly))
+        return false;
+
     QJsonDocument json = QJsonDocument::fromJson(index.readAll());
     if (!json.isObject())
-        return;
+        return false;
     auto root = json.object();
     // check file version first
     auto version_val = root.value("version");
     if (!version_val.isString())
-        return;
+        return false;
     if (version_val.toString() != "1")
-        return;
+        return false;
 
     // read the entry array
     auto entries_val = root.value("entries");
     if (!entries_val.isArray())
-        return;
+        return false;
+
+    qDebug() << "Converting meta cache index" << m_index_file;
+    for (auto &map : m_entries)
+    {
+        map.loaded = true;
+        map.needsCompaction = true;
+    }
     QJsonArray array = entries_val.toArray();
     for (auto element : array)
     {
         if (!element.isObject())
-            return;
+            break;
         auto element_obj = element.toObject();
         QString base = element_obj.value("base").toString();
         if (!m_entries.contains(base))
@@ -220,6 +498,7 @@ void HttpMetaCache::Load()
         foo->stale = false;
         entrymap.entry_list[path] = MetaEntryPtr(foo);
     }
+    return true;
 }
 
 void HttpMetaCache::SaveEventually()
@@ -233,40 +512,101 @@ void HttpMetaCache::SaveNow()
 {
     if(m_index_file.isNull())
         return;
-    QJsonObject toplevel;
-    toplevel.insert("version", QJsonValue(QString("1")));
-    QJsonArray entriesArr;
-    for (auto group : m_entries)
+    for (auto iter = m_entries.begin(); iter != m_entries.end(); iter++)
+    {
+        auto &map = iter.value();
+        if(!map.loaded || (map.dirty.isEmpty() && !map.needsCompaction))
+            continue;
+        saveBase(iter.key(), map);
+    }
+}
+
+namespace {
+void writePut(QDataStream &out, const QString &path, const QString &md5sum, const QString &etag, qint64 local, const QString &remote)
+{
+    out << quint8(PutRecord) << path << md5sum << etag << local << remote;
+}
+}
+
+void HttpMetaCache::saveBase(const QString &base, EntryMap &map)
+{
+    if(!FS::ensureFolderPathExists(m_index_dir))
+    {
+        qWarning() << "Cannot create meta cache index folder" << m_index_dir;
+        return;
+    }
+    auto indexPath = baseIndexPath(base);
+
+    int live = 0;
+    for (auto &entry : map.entry_list)
+    {
+        if(!entry->stale)
+            live++;
+    }
+    bool compact = map.needsCompaction || map.records + map.dirty.size() > live * 2 + compactionSlack;
+
+    if(compact)
     {
-        for (auto entry : group.entry_list)
+        QSaveFile index(indexPath);
+        if(!index.open(QIODevice::WriteOnly))
+        {
+            qWarning() << "Couldn't open" << indexPath << "for writing:" << index.errorString();
+            return;
+        }
+        QDataStream out(&index);
+        out.setVersion(streamVersion);
+        out << indexMagic << indexVersion;
+        int records = 0;
+        for (auto &entry : map.entry_list)
         {
             // do not save stale entries. they are dead.
             if(entry->stale)
-            {
                 continue;
-            }
-            QJsonObject entryObj;
-            entryObj.insert("base", QJsonValue(entry->baseId));
-            entryObj.insert("path", QJsonValue(entry->relativePath));
-            entryObj.insert("md5sum", QJsonValue(entry->md5sum));
-            entryObj.insert("etag", QJsonValue(entry->etag));
-            entryObj.insert("last_changed_timestamp",
-                            QJsonValue(double(entry->local_changed_timestamp)));
-            if (!entry->remote_changed_timestamp.isEmpty())
-                entryObj.insert("remote_changed_timestamp",
-                                QJsonValue(entry->remote_changed_timestamp));
-            entriesArr.append(entryObj);
+            writePut(out, entry->relativePath, entry->md5sum, entry->etag, entry->local_changed_timestamp, entry->remote_changed_timestamp);
+            records++;
         }
+        if(out.status() != QDataStream::Ok || !index.commit())
+        {
+            qWarning() << "Error while writing" << indexPath << ":" << index.errorString();
+            return;
+        }
+        map.records = records;
+        map.needsCompaction = false;
+        map.dirty.clear();
+        return;
     }
-    toplevel.insert("entries", entriesArr);
 
-    QJsonDocument doc(toplevel);
-    try
+    QFile index(indexPath);
+    if(!index.open(QIODevice::WriteOnly | QIODevice::Append))
     {
-        FS::write(m_index_file, doc.toJson());
+        qWarning() << "Couldn't open" << indexPath << "for appending:" << index.errorString();
+        return;
+    }
+    QDataStream out(&index);
+    out.setVersion(streamVersion);
+    if(index.size() == 0)
+    {
+        out << indexMagic << indexVersion;
+    }
+    for (auto &path : map.dirty)
+    {
+        auto entry = map.entry_list.value(path);
+        if(entry && !entry->stale)
+        {
+            writePut(out, path, entry->md5sum, entry->etag, entry->local_changed_timestamp, entry->remote_changed_timestamp);
+        }
+        else
+        {
+            out << quint8(RemoveRecord) << path;
+        }
+        map.records++;
     }
-    catch (const Exception &e)
+    index.close();
+    if(out.status() != QDataStream::Ok)
     {
-        qWarning() << e.what();
+        qWarning() << "Error while appending to" << indexPath;
+        map.needsCompaction = true;
+        return;
     }
+    map.dirty.clear();
 }
@@ -16,7 +16,12 @@
 #pragma once
 #include <QString>
 #include <QMap>
+#include <QSet>
 #include <qtimer.h>
+#include <QThreadPool>
+#include <QMutex>
+#include <QFuture>
+#include <QCryptographicHash>
 #include <memory>
 
 class HttpMetaCache;
@@ -64,6 +69,17 @@ public:
     {
         this->md5sum = md5sum;
     }
+    /*
+     * When the server last confirmed that the file is current, and for how long it said the file stays current.
+     * This is only kept in memory, so the first request after starting the launcher always goes out.
+     */
+    void setConfirmed(qint64 timestamp, qint64 maxAge)
+    {
+        confirmed_timestamp = timestamp;
+        max_age = maxAge;
+    }
+    // defaultMaxAge is used when the server didn't say how long the file stays current
+    bool isFresh(qint64 defaultMaxAge) const;
 protected:
     QString baseId;
     QString basePath;
@@ -73,6 +89,9 @@ protected:
     qint64 local_changed_timestamp = 0;
     QString remote_changed_timestamp; // QString for now, RFC 2822 encoded time
     bool stale = true;
+    qint64 confirmed_timestamp = 0;
+    // in milliseconds, -1 if the server didn't say
+    qint64 max_age = -1;
 };
 
 typedef std::shared_ptr<MetaEntry> MetaEntryPtr;
@@ -89,10 +108,24 @@ public:
     // you probably don't want this, unless you have some specific caching needs.
     MetaEntryPtr getEntry(QString base, QString resource_path);
 
-    // get the entry from cache and verify that it isn't stale (within reason)
+    // get the entry from cache and verify that it isn't stale (within reason).
+    // files that changed since they were last checked are never read here: they come back stale and are checked in the
+    // background, see revalidate().
     MetaEntryPtr resolveEntry(QString base, QString resource_path,
                               QString expected_etag = QString());
 
+    struct Revalidation
+    {
+        QString resource_path;
+        // checksum the file is known to have when it's intact, used instead of the stored MD5 when present
+        QCryptographicHash::Algorithm algorithm = QCryptographicHash::Sha1;
+        QByteArray expected_hash;
+    };
+
+    // check the files of many entries on a background thread pool, so resolving them afterwards is cheap.
+    // entries that fail the check are disowned.
+    QFuture<void> revalidate(QString base, const QList<Revalidation> &revalidations);
+
     // add a previously resolved stale entry
     bool updateEntry(MetaEntryPtr stale_entry);
 
@@ -109,15 +142,48 @@ public
 slots:
     void SaveNow();
 
+private
+slots:
+    // apply results of background revalidation, on the thread that owns the cache
+    void applyRevalidations();
+
 private:
-    // create a new stale entry, given the parameters
-    MetaEntryPtr staleEntry(QString base, QString resource_path);
     struct EntryMap
     {
         QString base_path;
         QMap<QString, MetaEntryPtr> entry_list;
+        // index file of this base has been read
+        bool loaded = false;
+        // entries changed (or removed) since the last save
+        QSet<QString> dirty;
+        // number of records in the index file, live or not
+        int records = 0;
+        // the index file must be rewritten instead of appended to
+        bool needsCompaction = false;
+    };
+
+    // create a new stale entry, given the parameters
+    MetaEntryPtr staleEntry(QString base, QString resource_path);
+    void markDirty(EntryMap &map, const QString &resource_path);
+    void ensureLoaded(const QString &base, EntryMap &map);
+    QString baseIndexPath(const QString &base) const;
+    void loadBase(const QString &base, EntryMap &map);
+    void saveBase(const QString &base, EntryMap &map);
+    bool migrateFromJson();
+
+    struct RevalidationResult
+    {
+        QString base;
+        MetaEntryPtr entry;
+        bool valid = false;
+        qint64 local_changed_timestamp = 0;
     };
+
     QMap<QString, EntryMap> m_entries;
+    QThreadPool m_hashPool;
+    QMutex m_revalidatedLock;
+    QList<RevalidationResult> m_revalidated;
     QString m_index_file;
+    QString m_index_dir;
     QTimer saveBatchingTimer;
 };
@@ -1,11 +1,55 @@
 #include "MetaCacheSink.h"
 #include <QFile>
 #include <QFileInfo>
+#include <QCryptographicHash>
+#include <QDateTime>
 #include "FileSystem.h"
+#include "ObjectStore.h"
 #include "Application.h"
 
 namespace Net {
 
+namespace {
+// How long the server says the response stays current, in milliseconds. -1 if it didn't say.
+qint64 serverMaxAge(QNetworkReply & reply)
+{
+    if(!reply.hasRawHeader("Cache-Control"))
+    {
+        return -1;
+    }
+    qint64 maxAge = -1;
+    auto directives = QString::fromLatin1(reply.rawHeader("Cache-Control")).split(',', QString::SkipEmptyParts);
+    for(auto directive: directives)
+    {
+        directive = directive.trimmed().toLower();
+        if(directive == "no-cache" || directive == "no-store")
+        {
+            return 0;
+        }
+        if(directive.startsWith("max-age="))
+        {
+            bool ok = false;
+            auto seconds = directive.mid(8).toLongLong(&ok);
+            if(ok && seconds >= 0)
+            {
+                maxAge = seconds * 1000;
+            }
+        }
+    }
+    // the response may have been sitting in a proxy for a while
+    if(maxAge > 0 && reply.hasRawHeader("Age"))
+    {
+        bool ok = false;
+        auto age = reply.rawHeader("Age").toLongLong(&ok);
+        if(ok && age > 0)
+        {
+            maxAge = qMax<qint64>(0, maxAge - age * 1000);
+        }
+    }
+    return maxAge;
+}
+}
+
 MetaCacheSink::MetaCacheSink(MetaEntryPtr entry, ChecksumValidator * md5sum)
     :Net::FileSink(entry->getFullPath()), m_entry(entry), m_md5Node(md5sum)
 {
@@ -53,6 +97,26 @@ JobStatus MetaCacheSink::finalizeCache(QNetworkReply & reply)
     }
     m_entry->setLocalChangedTimestamp(output_file_info.lastModified().toUTC().toMSecsSinceEpoch());
     m_entry->setStale(false);
+    // both a fresh download and a 304 mean the server just confirmed what we have
+    m_entry->setConfirmed(QDateTime::currentMSecsSinceEpoch(), serverMaxAge(reply));
+    APPLICATION->metacache()->updateEntry(m_entry);
+    return Job_Finished;
+}
+
+JobStatus MetaCacheSink::finalizeFromObjectStore()
+{
+    // the store remembers the MD5 of its objects, no need to read the file again
+    auto checksum = expectedChecksum();
+    auto md5 = ObjectStore::global().md5(checksum->algorithm(), checksum->expected());
+    if(md5.isEmpty())
+    {
+        return Job_Failed;
+    }
+    m_entry->setMD5Sum(md5.toHex().constData());
+    m_entry->setETag(QString());
+    m_entry->setRemoteChangedTimestamp(QString());
+    m_entry->setLocalChangedTimestamp(QFileInfo(m_filename).lastModified().toUTC().toMSecsSinceEpoch());
+    m_entry->setStale(false);
     APPLICATION->metacache()->updateEntry(m_entry);
     return Job_Finished;
 }
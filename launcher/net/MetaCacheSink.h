@@ -14,6 +14,7 @@ public: /* con/des */
 protected: /* methods */
     JobStatus initCache(QNetworkRequest & request) override;
     JobStatus finalizeCache(QNetworkReply & reply) override;
+    JobStatus finalizeFromObjectStore() override;
 
 private: /* data */
     MetaEntryPtr m_entry;
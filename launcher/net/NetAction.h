@@ -80,6 +80,27 @@ public:
         return m_url;
     }
 
+    /// True if the last failure looks like the host is overloaded: connection errors, timeouts, 429 and 5xx responses
+    bool failedFromOverload() const
+    {
+        if(m_httpStatus == 429 || m_httpStatus >= 500)
+        {
+            return true;
+        }
+        switch(m_error)
+        {
+            case QNetworkReply::ConnectionRefusedError:
+            case QNetworkReply::RemoteHostClosedError:
+            case QNetworkReply::TimeoutError:
+            case QNetworkReply::TemporaryNetworkFailureError:
+            case QNetworkReply::NetworkSessionFailedError:
+            case QNetworkReply::UnknownNetworkError:
+                return true;
+            default:
+                return false;
+        }
+    }
+
 signals:
     void started(int index);
     void netActionProgress(int index, qint64 current, qint64 total);
@@ -102,6 +123,16 @@ public slots:
 protected:
     virtual void startImpl() = 0;
 
+    /// Remember why the current reply failed, see failedFromOverload()
+    void recordError(QNetworkReply::NetworkError error)
+    {
+        m_error = error;
+        if(m_reply)
+        {
+            m_httpStatus = m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        }
+    }
+
 public:
     shared_qobject_ptr<QNetworkAccessManager> m_network;
 
@@ -119,4 +150,6 @@ public:
 
 protected:
     JobStatus m_status = Job_NotStarted;
+    QNetworkReply::NetworkError m_error = QNetworkReply::NoError;
+    int m_httpStatus = 0;
 };
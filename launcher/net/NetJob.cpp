@@ -15,15 +15,70 @@
 
 #include "NetJob.h"
 #include "Download.h"
+#include "ConnectionScheduler.h"
 
 #include <QDebug>
 
+NetJob::NetJob(QString job_name, shared_qobject_ptr<QNetworkAccessManager> network) : Task(), m_network(network)
+{
+    setObjectName(job_name);
+    // other jobs finishing their requests can free up slots for us
+    connect(&Net::ConnectionScheduler::global(), &Net::ConnectionScheduler::slotsAvailable, this, &NetJob::startMoreParts);
+}
+
+void NetJob::releaseSlot(int index, bool success)
+{
+    auto &slot = parts_progress[index];
+    if(!slot.scheduled)
+    {
+        return;
+    }
+    slot.scheduled = false;
+    auto &scheduler = Net::ConnectionScheduler::global();
+    if(slot.starting || m_aborted)
+    {
+        // finished without talking to the host (cache hits, aborts), nothing to learn from that
+        scheduler.releaseUnmeasured(slot.host);
+    }
+    else
+    {
+        Net::ConnectionScheduler::Measurement measurement;
+        auto elapsed = slot.timer.elapsed();
+        measurement.success = success;
+        measurement.overloaded = !success && downloads[index]->failedFromOverload();
+        // a response that came in one piece only shows up at the end
+        measurement.firstByteMs = slot.firstByteMs >= 0 ? slot.firstByteMs : elapsed;
+        measurement.transferMs = elapsed - measurement.firstByteMs;
+        measurement.bytes = slot.current_progress;
+        scheduler.release(slot.host, measurement);
+    }
+}
+
+void NetJob::trackTodoHost(const QString& host)
+{
+    m_todoHosts[host]++;
+}
+
+void NetJob::untrackTodoHost(const QString& host)
+{
+    auto iter = m_todoHosts.find(host);
+    if(iter == m_todoHosts.end())
+    {
+        return;
+    }
+    if(--(*iter) <= 0)
+    {
+        m_todoHosts.erase(iter);
+    }
+}
+
 void NetJob::partSucceeded(int index)
 {
     // do progress. all slots are 1 in size at least
     auto &slot = parts_progress[index];
     partProgress(index, slot.total_progress, slot.total_progress);
 
+    releaseSlot(index, true);
     m_doing.remove(index);
     m_done.insert(index);
     downloads[index].get()->disconnect(this);
@@ -32,6 +87,7 @@ void NetJob::partSucceeded(int index)
 
 void NetJob::partFailed(int index)
 {
+    releaseSlot(index, false);
     m_doing.remove(index);
     auto &slot = parts_progress[index];
     if (slot.failures == 3)
@@ -42,6 +98,7 @@ void NetJob::partFailed(int index)
     {
         slot.failures++;
         m_todo.enqueue(index);
+        trackTodoHost(slot.host);
     }
     downloads[index].get()->disconnect(this);
     startMoreParts();
@@ -50,6 +107,7 @@ void NetJob::partFailed(int index)
 void NetJob::partAborted(int index)
 {
     m_aborted = true;
+    releaseSlot(index, false);
     m_doing.remove(index);
     m_failed.insert(index);
     downloads[index].get()->disconnect(this);
@@ -61,6 +119,10 @@ void NetJob::partProgress(int index, qint64 bytesReceived, qint64 bytesTotal)
     auto &slot = parts_progress[index];
     slot.current_progress = bytesReceived;
     slot.total_progress = bytesTotal;
+    if(slot.scheduled && slot.firstByteMs < 0 && bytesReceived > 0)
+    {
+        slot.firstByteMs = slot.timer.elapsed();
+    }
 
     int done = m_done.size();
     int doing = m_doing.size();
@@ -103,6 +165,23 @@ void NetJob::executeTask()
 }
 
 void NetJob::startMoreParts()
+{
+    if(m_startingParts)
+    {
+        // a part finished while it was being started, the running call takes another pass for it
+        m_startMoreAgain = true;
+        return;
+    }
+    m_startingParts = true;
+    do
+    {
+        m_startMoreAgain = false;
+        startMorePartsPass();
+    } while(m_startMoreAgain);
+    m_startingParts = false;
+}
+
+void NetJob::startMorePartsPass()
 {
     if(!isRunning())
     {
@@ -130,21 +209,54 @@ void NetJob::startMoreParts()
         }
         return;
     }
-    // There's work to do, try to start more parts.
-    while (m_doing.size() < 6)
+    // There's work to do, try to start more parts - as many as the connection scheduler lets us.
+    // Parts for hosts that are at their limit stay queued so they don't hold up parts for other hosts.
+    // Parts are only removed here, retries are appended at the end, so the position stays valid while parts start.
+    auto &scheduler = Net::ConnectionScheduler::global();
+    QSet<QString> saturatedHosts;
+    int position = 0;
+    while (position < m_todo.size())
     {
-        if(!m_todo.size())
+        if(!isRunning())
+        {
+            // a synchronously finished part may have failed the whole job
             return;
-        int doThis = m_todo.dequeue();
-        m_doing.insert(doThis);
+        }
+        if(!scheduler.hasFreeSlots() || saturatedHosts.size() == m_todoHosts.size())
+        {
+            // wait for slotsAvailable
+            return;
+        }
+        int doThis = m_todo[position];
         auto part = downloads[doThis];
+        auto &slot = parts_progress[doThis];
+        if(saturatedHosts.contains(slot.host))
+        {
+            position++;
+            continue;
+        }
+        if(!scheduler.tryAcquire(slot.host))
+        {
+            saturatedHosts.insert(slot.host);
+            position++;
+            continue;
+        }
+        m_todo.removeAt(position);
+        untrackTodoHost(slot.host);
+        m_doing.insert(doThis);
+        slot.scheduled = true;
+        slot.firstByteMs = -1;
+        slot.timer.start();
         // connect signals :D
         connect(part.get(), SIGNAL(succeeded(int)), SLOT(partSucceeded(int)));
         connect(part.get(), SIGNAL(failed(int)), SLOT(partFailed(int)));
         connect(part.get(), SIGNAL(aborted(int)), SLOT(partAborted(int)));
         connect(part.get(), SIGNAL(netActionProgress(int, qint64, qint64)),
                 SLOT(partProgress(int, qint64, qint64)));
+        slot.starting = true;
         part->start(m_network);
+        // NOTE: the part may have finished already, its slot is free again and gets picked up by the next pass
+        parts_progress[doThis].starting = false;
     }
 }
 
@@ -184,6 +296,7 @@ bool NetJob::abort()
     // fail all waiting
     m_failed.unite(m_todo.toSet());
     m_todo.clear();
+    m_todoHosts.clear();
     // abort active
     auto toKill = m_doing.toList();
     for(auto index: toKill)
@@ -199,6 +312,7 @@ bool NetJob::addNetAction(NetAction::Ptr action)
     action->m_index_within_job = downloads.size();
     downloads.append(action);
     part_info pi;
+    pi.host = action->url().host();
     parts_progress.append(pi);
     partProgress(parts_progress.count() - 1, action->currentProgress(), action->totalProgress());
 
@@ -211,8 +325,17 @@ bool NetJob::addNetAction(NetAction::Ptr action)
     else
     {
         m_todo.append(parts_progress.size() - 1);
+        trackTodoHost(pi.host);
     }
     return true;
 }
 
-NetJob::~NetJob() = default;
+NetJob::~NetJob()
+{
+    // a job dropped while parts are still running has to hand their slots back, or they are gone for good
+    m_aborted = true;
+    for(int i = 0; i < parts_progress.size(); i++)
+    {
+        releaseSlot(i, false);
+    }
+}
@@ -21,6 +21,8 @@
 #include "tasks/Task.h"
 #include "QObjectPtr.h"
 
+#include <QElapsedTimer>
+
 class NetJob;
 
 class NetJob : public Task
@@ -29,10 +31,7 @@ class NetJob : public Task
 public:
     using Ptr = shared_qobject_ptr<NetJob>;
 
-    explicit NetJob(QString job_name, shared_qobject_ptr<QNetworkAccessManager> network) : Task(), m_network(network)
-    {
-        setObjectName(job_name);
-    }
+    explicit NetJob(QString job_name, shared_qobject_ptr<QNetworkAccessManager> network);
     virtual ~NetJob();
 
     bool addNetAction(NetAction::Ptr action);
@@ -73,6 +72,11 @@ private slots:
     void partAborted(int index);
 
 private:
+    void startMorePartsPass();
+    void releaseSlot(int index, bool success);
+    void trackTodoHost(const QString & host);
+    void untrackTodoHost(const QString & host);
+
     shared_qobject_ptr<QNetworkAccessManager> m_network;
 
     struct part_info
@@ -80,13 +84,26 @@ private:
         qint64 current_progress = 0;
         qint64 total_progress = 1;
         int failures = 0;
+        // holds a slot in the connection scheduler
+        bool scheduled = false;
+        // the part is inside start() - it did not go to the network if it finishes now
+        bool starting = false;
+        QString host;
+        QElapsedTimer timer;
+        // when the first byte of the response arrived, -1 before that
+        qint64 firstByteMs = -1;
     };
     QList<NetAction::Ptr> downloads;
     QList<part_info> parts_progress;
     QQueue<int> m_todo;
+    // number of queued parts per host
+    QHash<QString, int> m_todoHosts;
     QSet<int> m_doing;
     QSet<int> m_done;
     QSet<int> m_failed;
     qint64 m_current_progress = 0;
     bool m_aborted = false;
+    // startMoreParts is running, parts finishing inside it only ask it for another pass
+    bool m_startingParts = false;
+    bool m_startMoreAgain = false;
 };
@@ -0,0 +1,332 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ObjectStore.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDirIterator>
+#include <QSaveFile>
+#include <QDebug>
+
+#include <algorithm>
+
+#include "FileSystem.h"
+
+namespace {
+QString algorithmName(QCryptographicHash::Algorithm algorithm)
+{
+    switch(algorithm)
+    {
+        case QCryptographicHash::Md5:
+            return "md5";
+        case QCryptographicHash::Sha1:
+            return "sha1";
+        case QCryptographicHash::Sha256:
+            return "sha256";
+        default:
+            return QString();
+    }
+}
+
+// hashes the file with the given algorithm and MD5 in one pass
+bool hashFile(const QString & path, QCryptographicHash::Algorithm algorithm, QByteArray & hash, QByteArray & md5)
+{
+    QFile input(path);
+    if(!input.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+    QCryptographicHash checksum(algorithm);
+    QCryptographicHash md5sum(QCryptographicHash::Md5);
+    while(!input.atEnd())
+    {
+        auto chunk = input.read(64 * 1024);
+        if(chunk.isEmpty() && input.error() != QFile::NoError)
+        {
+            return false;
+        }
+        checksum.addData(chunk);
+        md5sum.addData(chunk);
+    }
+    hash = checksum.result();
+    md5 = md5sum.result();
+    return true;
+}
+
+const QString infoSuffix = ".info";
+// its modification time is when the store was last pruned
+const QString pruneStampName = "last-prune";
+const qint64 pruneIntervalMs = 24 * 60 * 60 * 1000;
+}
+
+namespace Net {
+
+ObjectStore & ObjectStore::global()
+{
+    static ObjectStore store;
+    return store;
+}
+
+void ObjectStore::setRoot(const QString& root)
+{
+    m_root = root;
+}
+
+bool ObjectStore::isEnabled() const
+{
+    return !m_root.isEmpty();
+}
+
+QString ObjectStore::objectPath(QCryptographicHash::Algorithm algorithm, const QByteArray& hash) const
+{
+    auto algoName = algorithmName(algorithm);
+    if(!isEnabled() || algoName.isEmpty() || hash.isEmpty())
+    {
+        return QString();
+    }
+    QString hex = QString::fromLatin1(hash.toHex());
+    return FS::PathCombine(m_root, algoName, hex.left(2), hex);
+}
+
+bool ObjectStore::fetch(QCryptographicHash::Algorithm algorithm, const QByteArray& hash, const QString& target)
+{
+    auto path = objectPath(algorithm, hash);
+    if(path.isEmpty())
+    {
+        return false;
+    }
+    QMutexLocker locker(&m_lock);
+    if(!QFileInfo::exists(path))
+    {
+        return false;
+    }
+    // objects are shared with instances, make sure nobody changed this one under our feet
+    ObjectInfo info;
+    if(!unchangedSinceVerified(path, info))
+    {
+        QByteArray actual, md5;
+        if(!hashFile(path, algorithm, actual, md5) || actual != hash)
+        {
+            qWarning() << "Object store entry" << path << "is corrupted, removing it.";
+            QFile::remove(path);
+            QFile::remove(infoPath(path));
+            return false;
+        }
+        writeInfo(path, md5);
+    }
+    // remember when it was last used, for pruning
+    FS::updateTimestamp(infoPath(path));
+    if(!FS::linkOrCopy(path, target))
+    {
+        qWarning() << "Failed to place object" << path << "at" << target;
+        return false;
+    }
+    return true;
+}
+
+bool ObjectStore::store(QCryptographicHash::Algorithm algorithm, const QByteArray& hash, const QString& source, const QByteArray& md5)
+{
+    auto path = objectPath(algorithm, hash);
+    if(path.isEmpty())
+    {
+        return false;
+    }
+    QMutexLocker locker(&m_lock);
+    if(QFileInfo::exists(path))
+    {
+        FS::updateTimestamp(infoPath(path));
+        return true;
+    }
+    if(!FS::linkOrCopy(source, path))
+    {
+        qWarning() << "Failed to add" << source << "to the object store";
+        return false;
+    }
+    // the caller verified the file against the digest, so this counts as verified
+    writeInfo(path, md5);
+    return true;
+}
+
+QByteArray ObjectStore::md5(QCryptographicHash::Algorithm algorithm, const QByteArray& hash)
+{
+    auto path = objectPath(algorithm, hash);
+    if(path.isEmpty())
+    {
+        return QByteArray();
+    }
+    QMutexLocker locker(&m_lock);
+    ObjectInfo info;
+    if(unchangedSinceVerified(path, info) && !info.md5.isEmpty())
+    {
+        return info.md5;
+    }
+    QByteArray actual, md5;
+    if(!hashFile(path, algorithm, actual, md5) || actual != hash)
+    {
+        return QByteArray();
+    }
+    writeInfo(path, md5);
+    return md5;
+}
+
+void ObjectStore::pruneIfDue(qint64 maxSize)
+{
+    if(!isEnabled() || maxSize <= 0)
+    {
+        return;
+    }
+    auto stampPath = FS::PathCombine(m_root, pruneStampName);
+    QFileInfo stamp(stampPath);
+    if(stamp.exists() && stamp.lastModified().msecsTo(QDateTime::currentDateTime()) < pruneIntervalMs)
+    {
+        return;
+    }
+    if(!stamp.exists())
+    {
+        if(!FS::ensureFilePathExists(stampPath))
+        {
+            return;
+        }
+        QFile(stampPath).open(QIODevice::WriteOnly);
+    }
+    FS::updateTimestamp(stampPath);
+    prune(maxSize);
+}
+
+void ObjectStore::prune(qint64 maxSize)
+{
+    if(!isEnabled())
+    {
+        return;
+    }
+    auto stampPath = FS::PathCombine(m_root, pruneStampName);
+    struct Object
+    {
+        QString path;
+        qint64 size;
+        qint64 lastUsed;
+    };
+    QList<Object> objects;
+    qint64 total = 0;
+    QDirIterator iter(m_root, QDir::Files, QDirIterator::Subdirectories);
+    while(iter.hasNext())
+    {
+        auto path = iter.next();
+        auto info = iter.fileInfo();
+        if(info.absoluteFilePath() == QFileInfo(stampPath).absoluteFilePath())
+        {
+            continue;
+        }
+        if(path.endsWith(infoSuffix))
+        {
+            // info left behind by an object that's gone
+            QMutexLocker locker(&m_lock);
+            if(!QFileInfo::exists(path.left(path.size() - infoSuffix.size())))
+            {
+                QFile::remove(path);
+            }
+            continue;
+        }
+        QFileInfo objectInfo(infoPath(path));
+        auto lastUsed = objectInfo.exists() ? objectInfo.lastModified() : info.lastModified();
+        objects.append({path, info.size(), lastUsed.toMSecsSinceEpoch()});
+        total += info.size();
+    }
+    if(total <= maxSize)
+    {
+        return;
+    }
+    std::sort(objects.begin(), objects.end(), [](const Object & a, const Object & b)
+    {
+        return a.lastUsed < b.lastUsed;
+    });
+    int removed = 0;
+    for(auto & object: objects)
+    {
+        if(total <= maxSize)
+        {
+            break;
+        }
+        QMutexLocker locker(&m_lock);
+        // used since the walk, keep it
+        QFileInfo objectInfo(infoPath(object.path));
+        if(objectInfo.exists() && objectInfo.lastModified().toMSecsSinceEpoch() != object.lastUsed)
+        {
+            continue;
+        }
+        if(QFile::remove(object.path))
+        {
+            QFile::remove(infoPath(object.path));
+            total -= object.size;
+            removed++;
+        }
+    }
+    qDebug() << "Removed" << removed << "objects from the object store, it now takes" << total << "bytes";
+}
+
+QString ObjectStore::infoPath(const QString& objectPath)
+{
+    return objectPath + infoSuffix;
+}
+
+bool ObjectStore::readInfo(const QString& objectPath, ObjectInfo& info)
+{
+    QFile input(infoPath(objectPath));
+    if(!input.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+    auto parts = input.readAll().trimmed().split(' ');
+    if(parts.size() < 2)
+    {
+        return false;
+    }
+    bool sizeOk = false, timeOk = false;
+    info.size = parts[0].toLongLong(&sizeOk);
+    info.lastModified = parts[1].toLongLong(&timeOk);
+    info.md5 = parts.size() > 2 ? QByteArray::fromHex(parts[2]) : QByteArray();
+    return sizeOk && timeOk;
+}
+
+void ObjectStore::writeInfo(const QString& objectPath, const QByteArray& md5)
+{
+    QFileInfo object(objectPath);
+    QSaveFile output(infoPath(objectPath));
+    if(!output.open(QIODevice::WriteOnly))
+    {
+        return;
+    }
+    auto line = QByteArray::number(object.size()) + ' ' + QByteArray::number(object.lastModified().toMSecsSinceEpoch());
+    if(!md5.isEmpty())
+    {
+        line += ' ' + md5.toHex();
+    }
+    output.write(line + '\n');
+    output.commit();
+}
+
+bool ObjectStore::unchangedSinceVerified(const QString& objectPath, ObjectInfo& info)
+{
+    if(!readInfo(objectPath, info))
+    {
+        return false;
+    }
+    QFileInfo object(objectPath);
+    return object.size() == info.size && object.lastModified().toMSecsSinceEpoch() == info.lastModified;
+}
+
+}
@@ -0,0 +1,89 @@
+/* Copyright 2013-2021 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QString>
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QMutex>
+
+namespace Net {
+
+/**
+ * Content addressed storage for everything we download with a known checksum.
+ *
+ * Objects live in <root>/<algorithm>/<first two hex digits>/<hex digest>.
+ * Downloads with an expected checksum are linked out of the store instead of being fetched again,
+ * and successful downloads are linked into it, so the same jar is only stored once no matter
+ * how many instances, caches or libraries folders use it.
+ *
+ * Next to each object, <hex digest>.info remembers the size and modification time the object had when it was
+ * last verified, and its MD5. As long as those match, the object is trusted without reading it again.
+ * The modification time of the .info file is the last time the object was used.
+ */
+class ObjectStore
+{
+public:
+    static ObjectStore & global();
+
+    /// Set the folder the store lives in. An empty root disables the store.
+    void setRoot(const QString & root);
+    bool isEnabled() const;
+
+    /// Path of the object with the given raw digest, or an empty string if the algorithm isn't supported
+    QString objectPath(QCryptographicHash::Algorithm algorithm, const QByteArray & hash) const;
+
+    /// Put the object with the given digest at target, if the store has it.
+    /// The object is verified first, unless it didn't change since it was last verified.
+    bool fetch(QCryptographicHash::Algorithm algorithm, const QByteArray & hash, const QString & target);
+
+    /// Add the file at source to the store, unless an object with that digest is already there.
+    /// md5 is the raw MD5 of the file, if the caller already knows it.
+    bool store(QCryptographicHash::Algorithm algorithm, const QByteArray & hash, const QString & source,
+               const QByteArray & md5 = QByteArray());
+
+    /// Raw MD5 of the object with the given digest, or an empty array if the store doesn't have it
+    QByteArray md5(QCryptographicHash::Algorithm algorithm, const QByteArray & hash);
+
+    /// Remove the objects that were used least recently, until the store takes up at most maxSize bytes.
+    /// Files placed by fetch() are links or copies, so they stay intact. Safe to call from any thread, objects that
+    /// fetch() or store() use while it runs are kept.
+    void prune(qint64 maxSize);
+
+    /// prune(), unless the store was already pruned in the last day
+    void pruneIfDue(qint64 maxSize);
+
+private:
+    ObjectStore() = default;
+
+    struct ObjectInfo
+    {
+        qint64 size = -1;
+        qint64 lastModified = 0;
+        QByteArray md5;
+    };
+    static QString infoPath(const QString & objectPath);
+    static bool readInfo(const QString & objectPath, ObjectInfo & info);
+    static void writeInfo(const QString & objectPath, const QByteArray & md5);
+    /// true if the object still looks the way it did when it was last verified
+    static bool unchangedSinceVerified(const QString & objectPath, ObjectInfo & info);
+
+    QString m_root;
+    // fetch, store and the removals of prune don't touch the same object at the same time
+    QMutex m_lock;
+};
+
+}
@@ -21,6 +21,113 @@
 #include <QStringList>
 #include <QSaveFile>
 #include <QDebug>
+#include <cstring>
+
+namespace {
+// the same characters QChar::isSpace() accepts below 128
+inline bool isAsciiSpace(char c)
+{
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+inline bool isAscii(char c)
+{
+    return uchar(c) < 0x80;
+}
+
+void trimAscii(const char *&begin, const char *&end)
+{
+    while (begin < end && isAsciiSpace(*begin))
+        begin++;
+    while (end > begin && isAsciiSpace(end[-1]))
+        end--;
+}
+
+// Same as QString::fromUtf8(...).trimmed(), without decoding the whitespace first
+QString decodeTrimmed(const char *begin, const char *end)
+{
+    trimAscii(begin, end);
+    if (begin < end && (!isAscii(*begin) || !isAscii(end[-1])))
+    {
+        // there may be non-ASCII whitespace left, QString knows about those
+        return QString::fromUtf8(begin, end - begin).trimmed();
+    }
+    return QString::fromUtf8(begin, end - begin);
+}
+
+// Same as INIFile::unescape(QString::fromUtf8(...).trimmed()). The escapes are all ASCII, so they can be resolved in UTF-8.
+QString decodeValue(const char *begin, const char *end)
+{
+    trimAscii(begin, end);
+    if (begin == end)
+    {
+        return QString();
+    }
+    if (!isAscii(*begin) || !isAscii(end[-1]))
+    {
+        return INIFile::unescape(QString::fromUtf8(begin, end - begin).trimmed());
+    }
+    auto backslash = static_cast<const char *>(memchr(begin, '\\', end - begin));
+    if (!backslash)
+    {
+        return QString::fromUtf8(begin, end - begin);
+    }
+    QByteArray out;
+    out.reserve(end - begin);
+    out.append(begin, backslash - begin);
+    bool escaped = false;
+    for (auto c = backslash; c < end; c++)
+    {
+        if (escaped)
+        {
+            if (*c == 'n')
+                out.append('\n');
+            else if (*c == 't')
+                out.append('\t');
+            else
+                out.append(*c);
+            escaped = false;
+        }
+        else if (*c == '\\')
+        {
+            escaped = true;
+        }
+        else
+        {
+            out.append(*c);
+        }
+    }
+    return QString::fromUtf8(out);
+}
+
+inline bool needsEscape(char c)
+{
+    return c == '\n' || c == '\t' || c == '\\' || c == '#';
+}
+
+// Same as escape(), on UTF-8
+void appendEscaped(QByteArray &out, const QByteArray &value)
+{
+    auto begin = value.constData();
+    auto end = begin + value.size();
+    auto plain = begin;
+    for (auto c = begin; c < end; c++)
+    {
+        if (!needsEscape(*c))
+            continue;
+        out.append(plain, c - plain);
+        out.append('\\');
+        if (*c == '\n')
+            out.append('n');
+        else if (*c == '\t')
+            out.append('t');
+        else
+            out.append(*c);
+        plain = c + 1;
+    }
+    out.append(plain, end - plain);
+}
+}
 
 INIFile::INIFile()
 {
@@ -28,7 +135,12 @@ INIFile::INIFile()
 
 QString INIFile::unescape(QString orig)
 {
+    if (!orig.contains('\\'))
+    {
+        return orig;
+    }
     QString out;
+    out.reserve(orig.size());
     QChar prev = 0;
     for(auto c: orig)
     {
@@ -61,6 +173,7 @@ QString INIFile::unescape(QString orig)
 QString INIFile::escape(QString orig)
 {
     QString out;
+    out.reserve(orig.size());
     for(auto c: orig)
     {
         if(c == '\n')
@@ -80,13 +193,12 @@ QString INIFile::escape(QString orig)
 bool INIFile::saveFile(QString fileName)
 {
     QByteArray outArray;
-    for (Iterator iter = begin(); iter != end(); iter++)
+    outArray.reserve(size() * 32);
+    for (auto iter = constBegin(); iter != constEnd(); iter++)
     {
-        QString value = iter.value().toString();
-        value = escape(value);
         outArray.append(iter.key().toUtf8());
         outArray.append('=');
-        outArray.append(value.toUtf8());
+        appendEscaped(outArray, iter.value().toString().toUtf8());
         outArray.append('\n');
     }
 
@@ -116,34 +228,48 @@ bool INIFile::loadFile(QString fileName)
 
 bool INIFile::loadFile(QByteArray file)
 {
-    QTextStream in(file);
-    in.setCodec("UTF-8");
+    // QTextStream used to read these and would have picked up UTF-16 and UTF-32 from the BOM
+    if (file.startsWith("\xFF\xFE") || file.startsWith("\xFE\xFF") || file.startsWith(QByteArray("\x00\x00\xFE\xFF", 4)))
+    {
+        QTextStream in(file);
+        in.setCodec("UTF-8");
+        file = in.readAll().toUtf8();
+    }
 
-    QStringList lines = in.readAll().split('\n');
-    for (int i = 0; i < lines.count(); i++)
+    auto data = file.constData();
+    auto end = data + file.size();
+    if (file.startsWith("\xEF\xBB\xBF"))
     {
-        QString &lineRaw = lines[i];
-        // Ignore comments.
-        int commentIndex = 0;
-        QString line = lineRaw;
-        // Search for comments until no more escaped # are available
-        while((commentIndex = line.indexOf('#', commentIndex + 1)) != -1) {
-            if(commentIndex > 0 && line.at(commentIndex - 1) == '\\') {
-                continue;
-            }
-            line = line.left(lineRaw.indexOf('#')).trimmed();
-        }
+        data += 3;
+    }
 
-        int eqPos = line.indexOf('=');
-        if (eqPos == -1)
-            continue;
-        QString key = line.left(eqPos).trimmed();
-        QString valueStr = line.right(line.length() - eqPos - 1).trimmed();
+    for (auto line = data; line; )
+    {
+        auto lineEnd = static_cast<const char *>(memchr(line, '\n', end - line));
+        const char *nextLine = lineEnd ? lineEnd + 1 : nullptr;
+        if (!lineEnd)
+        {
+            lineEnd = end;
+        }
 
-        valueStr = unescape(valueStr);
+        // A # starts a comment, which runs from the first # on the line. A # at the very start, or
+        // escaped with a backslash doesn't count, but still is where the comment starts if there is one.
+        auto firstHash = static_cast<const char *>(memchr(line, '#', lineEnd - line));
+        for (auto hash = firstHash; hash; hash = static_cast<const char *>(memchr(hash + 1, '#', lineEnd - hash - 1)))
+        {
+            if (hash > line && hash[-1] != '\\')
+            {
+                lineEnd = firstHash;
+                break;
+            }
+        }
 
-        QVariant value(valueStr);
-        this->operator[](key) = value;
+        auto eqPos = static_cast<const char *>(memchr(line, '=', lineEnd - line));
+        if (eqPos)
+        {
+            insert(decodeTrimmed(line, eqPos), QVariant(decodeValue(eqPos + 1, lineEnd)));
+        }
+        line = nextLine;
     }
 
     return true;
@@ -3,6 +3,80 @@
 
 #include "settings/INIFile.h"
 
+#include "FileSystem.h"
+
+#include <QDir>
+#include <QTextStream>
+#include <QStringList>
+
+namespace {
+// What INIFile used to do, kept to check the parser and serializer against it
+QMap<QString, QVariant> referenceLoad(const QByteArray &file)
+{
+    QMap<QString, QVariant> out;
+    QTextStream in(file);
+    in.setCodec("UTF-8");
+
+    QStringList lines = in.readAll().split('\n');
+    for (int i = 0; i < lines.count(); i++)
+    {
+        QString &lineRaw = lines[i];
+        int commentIndex = 0;
+        QString line = lineRaw;
+        while((commentIndex = line.indexOf('#', commentIndex + 1)) != -1) {
+            if(commentIndex > 0 && line.at(commentIndex - 1) == '\\') {
+                continue;
+            }
+            line = line.left(lineRaw.indexOf('#')).trimmed();
+        }
+
+        int eqPos = line.indexOf('=');
+        if (eqPos == -1)
+            continue;
+        QString key = line.left(eqPos).trimmed();
+        QString valueStr = line.right(line.length() - eqPos - 1).trimmed();
+        out[key] = QVariant(INIFile::unescape(valueStr));
+    }
+    return out;
+}
+
+QByteArray referenceSave(const QMap<QString, QVariant> &values)
+{
+    QByteArray outArray;
+    for (auto iter = values.begin(); iter != values.end(); iter++)
+    {
+        outArray.append(iter.key().toUtf8());
+        outArray.append('=');
+        outArray.append(INIFile::escape(iter.value().toString()).toUtf8());
+        outArray.append('\n');
+    }
+    return outArray;
+}
+
+void compareToReference(const QByteArray &data)
+{
+    INIFile parsed;
+    QVERIFY(parsed.loadFile(data));
+    auto expected = referenceLoad(data);
+    QCOMPARE(parsed.keys(), expected.keys());
+    for (auto iter = expected.begin(); iter != expected.end(); iter++)
+    {
+        QCOMPARE(parsed.value(iter.key()).toString(), iter.value().toString());
+    }
+}
+
+QList<QByteArray> corpus()
+{
+    QList<QByteArray> files;
+    QDir dir(QFINDTESTDATA("testdata/configs"));
+    for (auto &name: dir.entryList({"*.cfg"}, QDir::Files, QDir::Name))
+    {
+        files.append(GET_TEST_FILE("testdata/configs/" + name));
+    }
+    return files;
+}
+}
+
 class IniFileTest : public QObject
 {
     Q_OBJECT
@@ -56,6 +130,104 @@ slots:
         QCOMPARE(a, f2.get("a","NOT SET").toString());
         QCOMPARE(b, f2.get("b","NOT SET").toString());
     }
+
+    void test_LoadLikeBefore_data()
+    {
+        QTest::addColumn<QByteArray>("data");
+        QTest::newRow("empty") << QByteArray();
+        QTest::newRow("plain") << QByteArray("a=b\nc=d");
+        QTest::newRow("whitespace") << QByteArray("  a \t=\v b c \f\r\n\n\n=\nnovalue\n");
+        QTest::newRow("crlf") << QByteArray("a=b\r\nc=d\r\n");
+        QTest::newRow("comments") << QByteArray("a=b # comment\n# whole line\n#starts=with hash\n#two=#hashes\nc=d#e#f");
+        QTest::newRow("escaped hash") << QByteArray("a=b\\#c\nd=e\\#f#g\nh=\\#");
+        QTest::newRow("escapes") << QByteArray("a=\\n\\t\\\\\\x\\\nb=trailing\\");
+        QTest::newRow("duplicates") << QByteArray("a=1\na=2\n=empty key");
+        QTest::newRow("utf-8") << QByteArray("n\xc3\xa4me=\xe5\xbb\xba\xe7\xad\x91 \xf0\x9f\x8f\xb0\nb=\xc2\xa0nbsp\xc2\xa0\n\xe2\x80\x83k\xe2\x80\x83=v");
+        QTest::newRow("bom") << QByteArray("\xef\xbb\xbf#a=b\nc=d");
+        QTest::newRow("invalid utf-8") << QByteArray("a=\xff\xfe\x80\nb=\xc3x");
+        QTest::newRow("utf-16") << QByteArray("\xff\xfe" "a\0=\0b\0\n\0", 10);
+        int i = 0;
+        for (auto &file: corpus())
+        {
+            QTest::newRow(qPrintable(QString("corpus %1").arg(i++))) << file;
+        }
+    }
+    void test_LoadLikeBefore()
+    {
+        QFETCH(QByteArray, data);
+        compareToReference(data);
+    }
+
+    void test_SaveLikeBefore()
+    {
+        INIFile values;
+        values.set("plain", "value");
+        values.set("escapes", "a\nb\tc\\d#e");
+        values.set("unicode", QString::fromUtf8("\xe5\xbb\xba\xe7\xad\x91 \xf0\x9f\x8f\xb0"));
+        values.set("bool", true);
+        values.set("int", 1234);
+        values.set("empty", QString());
+        QString filename = "test_SaveLikeBefore.ini";
+        QVERIFY(values.saveFile(filename));
+        QFile file(filename);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QCOMPARE(file.readAll(), referenceSave(values));
+    }
+
+    void test_benchmarkLoad_data()
+    {
+        QTest::addColumn<bool>("reference");
+        QTest::newRow("before") << true;
+        QTest::newRow("after") << false;
+    }
+    void test_benchmarkLoad()
+    {
+        QFETCH(bool, reference);
+        auto files = corpus();
+        QVERIFY(!files.isEmpty());
+        // a few hundred instances worth of configs
+        QBENCHMARK
+        {
+            for (int i = 0; i < 300; i++)
+            {
+                auto &data = files[i % files.size()];
+                if (reference)
+                {
+                    referenceLoad(data);
+                }
+                else
+                {
+                    INIFile parsed;
+                    parsed.loadFile(data);
+                }
+            }
+        }
+    }
+
+    void test_benchmarkSave_data()
+    {
+        QTest::addColumn<bool>("reference");
+        QTest::newRow("before") << true;
+        QTest::newRow("after") << false;
+    }
+    void test_benchmarkSave()
+    {
+        QFETCH(bool, reference);
+        INIFile values;
+        values.loadFile(GET_TEST_FILE("testdata/configs/modded.cfg"));
+        QString filename = "test_benchmarkSave.ini";
+        QBENCHMARK
+        {
+            if (reference)
+            {
+                FS::write(filename, referenceSave(values));
+            }
+            else
+            {
+                values.saveFile(filename);
+            }
+        }
+    }
 };
 
 QTEST_GUILESS_MAIN(IniFileTest)
@@ -16,21 +16,196 @@
 #include "INISettingsObject.h"
 #include "Setting.h"
 
+#include <QFileInfo>
+#include <QDateTime>
+#include <QThreadPool>
+#include <QtConcurrentRun>
+#include <QDebug>
+
+namespace {
+// how long changes have to stop coming in before they are written...
+const int writeDelayMs = 500;
+// ... unless they have been pending for this long already
+const int maxWriteDelayMs = 3000;
+
+// one thread, so writes of the same file happen in the order they were made
+QThreadPool & writerPool()
+{
+    static QThreadPool pool;
+    pool.setMaxThreadCount(1);
+    return pool;
+}
+
+QSet<INISettingsObject *> & pendingObjects()
+{
+    static QSet<INISettingsObject *> pending;
+    return pending;
+}
+}
+
 INISettingsObject::INISettingsObject(const QString &path, QObject *parent)
     : SettingsObject(parent)
 {
     m_filePath = path;
     m_ini.loadFile(path);
+    updateStamp();
+}
+
+INISettingsObject::INISettingsObject(const QString& path, const INIFile& contents, qint64 stamp, QObject* parent)
+    : SettingsObject(parent), m_ini(contents), m_filePath(path), m_stamp(stamp)
+{
+}
+
+INISettingsObject::~INISettingsObject()
+{
+    flush();
+}
+
+void INISettingsObject::setWriteBehind(bool writeBehind)
+{
+    if(!writeBehind)
+    {
+        flush();
+    }
+    else if(!m_writeBehind)
+    {
+        m_writeTimer.setSingleShot(true);
+        connect(&m_writeTimer, &QTimer::timeout, this, &INISettingsObject::writePending);
+        connect(&m_writeWatcher, &QFutureWatcher<qint64>::finished, this, &INISettingsObject::writeFinished);
+    }
+    m_writeBehind = writeBehind;
+}
+
+void INISettingsObject::writePending()
+{
+    if(!m_dirty)
+    {
+        return;
+    }
+    m_dirty = false;
+    pendingObjects().remove(this);
+    // the writer gets its own copy, so nothing here has to wait for it
+    INIFile contents = m_ini;
+    QString path = m_filePath;
+    m_writeWatcher.setFuture(QtConcurrent::run(&writerPool(), [contents, path]() mutable -> qint64
+    {
+        if(!contents.saveFile(path))
+        {
+            return -1;
+        }
+        return QFileInfo(path).lastModified().toMSecsSinceEpoch();
+    }));
+}
+
+void INISettingsObject::writeFinished()
+{
+    auto stamp = m_writeWatcher.result();
+    if(stamp < 0)
+    {
+        qWarning() << "Failed to write settings to" << m_filePath;
+        return;
+    }
+    // a later synchronous flush may have gotten there first
+    m_stamp = qMax(m_stamp, stamp);
+}
+
+void INISettingsObject::flush()
+{
+    m_writeTimer.stop();
+    if(!m_dirty)
+    {
+        return;
+    }
+    m_dirty = false;
+    pendingObjects().remove(this);
+    // older writes of this file may still be queued, they must not land after this one
+    writerPool().waitForDone();
+    if(!m_ini.saveFile(m_filePath))
+    {
+        qWarning() << "Failed to write settings to" << m_filePath;
+    }
+    updateStamp();
+}
+
+void INISettingsObject::flushAll()
+{
+    auto pending = pendingObjects();
+    for(auto object: pending)
+    {
+        object->flush();
+    }
+    writerPool().waitForDone();
+}
+
+void INISettingsObject::deferLoading(const QSet<QString>& coveredKeys)
+{
+    m_loaded = false;
+    m_coveredKeys = coveredKeys;
+}
+
+bool INISettingsObject::ensureLoaded()
+{
+    if(m_loaded)
+    {
+        return true;
+    }
+    // without a file, the partial copy is all there is
+    if(QFileInfo::exists(m_filePath))
+    {
+        INIFile full;
+        if(!readFile(full))
+        {
+            qWarning() << "Failed to read settings from" << m_filePath << "- not writing them until it can be read.";
+            return false;
+        }
+        m_ini = full;
+    }
+    m_loaded = true;
+    m_coveredKeys.clear();
+    updateStamp();
+    return true;
+}
+
+bool INISettingsObject::readFile(INIFile& contents)
+{
+    return contents.loadFile(m_filePath);
+}
+
+void INISettingsObject::updateStamp()
+{
+    m_stamp = QFileInfo(m_filePath).lastModified().toMSecsSinceEpoch();
+}
+
+INIFile INISettingsObject::values(const QSet<QString>& keys) const
+{
+    INIFile out;
+    for(auto & key: keys)
+    {
+        auto iter = m_ini.constFind(key);
+        if(iter != m_ini.constEnd())
+        {
+            out.insert(key, *iter);
+        }
+    }
+    return out;
 }
 
 void INISettingsObject::setFilePath(const QString &filePath)
 {
+    // pending changes belong to the old file
+    flush();
     m_filePath = filePath;
 }
 
 bool INISettingsObject::reload()
 {
-    return m_ini.loadFile(m_filePath) && SettingsObject::reload();
+    // changes made so far would have been on disk already without write-behind
+    flush();
+    m_loaded = true;
+    m_coveredKeys.clear();
+    bool loaded = m_ini.loadFile(m_filePath);
+    updateStamp();
+    return loaded && SettingsObject::reload();
 }
 
 void INISettingsObject::suspendSave()
@@ -43,7 +218,11 @@ void INISettingsObject::resumeSave()
     m_suspendSave = false;
     if(m_doSave)
     {
-        m_ini.saveFile(m_filePath);
+        m_doSave = false;
+        if(ensureLoaded())
+        {
+            doSave();
+        }
     }
 }
 
@@ -51,6 +230,12 @@ void INISettingsObject::changeSetting(const Setting &setting, QVariant value)
 {
     if (contains(setting.id()))
     {
+        // never write back a partial file
+        if(!ensureLoaded())
+        {
+            qWarning() << "Not changing" << setting.id() << "in" << m_filePath;
+            return;
+        }
         // valid value -> set the main config, remove all the sysnonyms
         if (value.isValid())
         {
@@ -75,9 +260,24 @@ void INISettingsObject::doSave()
     {
         m_doSave = true;
     }
+    else if(m_writeBehind)
+    {
+        if(!m_dirty)
+        {
+            m_dirty = true;
+            m_dirtySince.start();
+            pendingObjects().insert(this);
+        }
+        // wait for a quiet moment, but don't let a steady stream of changes hold the write back forever
+        if(!m_writeTimer.isActive() || m_dirtySince.elapsed() < maxWriteDelayMs)
+        {
+            m_writeTimer.start(writeDelayMs);
+        }
+    }
     else
     {
         m_ini.saveFile(m_filePath);
+        updateStamp();
     }
 }
 
@@ -86,6 +286,11 @@ void INISettingsObject::resetSetting(const Setting &setting)
     // if we have the setting, remove all the synonyms. ALL OF THEM
     if (contains(setting.id()))
     {
+        if(!ensureLoaded())
+        {
+            qWarning() << "Not resetting" << setting.id() << "in" << m_filePath;
+            return;
+        }
         for(auto iter: setting.configKeys())
             m_ini.remove(iter);
         doSave();
@@ -97,6 +302,17 @@ QVariant INISettingsObject::retrieveValue(const Setting &setting)
     // if we have the setting, return value of the first matching synonym
     if (contains(setting.id()))
     {
+        if(!m_loaded)
+        {
+            for(auto iter: setting.configKeys())
+            {
+                if(!m_coveredKeys.contains(iter))
+                {
+                    ensureLoaded();
+                    break;
+                }
+            }
+        }
         for(auto iter: setting.configKeys())
         {
             if(m_ini.contains(iter))
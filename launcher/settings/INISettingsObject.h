@@ -16,6 +16,10 @@
 #pragma once
 
 #include <QObject>
+#include <QSet>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QFutureWatcher>
 
 #include "settings/INIFile.h"
 
@@ -29,6 +33,42 @@ class INISettingsObject : public SettingsObject
     Q_OBJECT
 public:
     explicit INISettingsObject(const QString &path, QObject *parent = 0);
+    /// Use contents that were already read from path, for example on another thread. stamp is the file's modification time then.
+    INISettingsObject(const QString &path, const INIFile &contents, qint64 stamp, QObject *parent = 0);
+    virtual ~INISettingsObject();
+
+    /**
+     * In write-behind mode, changes are collected and written on a background thread once they stop coming in.
+     * Otherwise every change is written right away.
+     *
+     * Pending changes are written when the object is destroyed, or by flush() and flushAll().
+     */
+    void setWriteBehind(bool writeBehind);
+
+    /// Write pending changes now
+    void flush();
+
+    /// Write pending changes of all settings objects and wait until everything is on disk
+    static void flushAll();
+
+    /**
+     * Treat the contents given to the constructor as a partial copy that is authoritative for the given keys.
+     * The file is only read once any other key is needed, or something is written.
+     */
+    void deferLoading(const QSet<QString> &coveredKeys);
+    bool isLoaded() const
+    {
+        return m_loaded;
+    }
+
+    /// Modification time of the file when its contents were last read or written, in ms since epoch
+    qint64 fileStamp() const
+    {
+        return m_stamp;
+    }
+
+    /// Raw values of the given keys, as far as they are set
+    INIFile values(const QSet<QString> &keys) const;
 
     /*!
      * \brief Gets the path to the INI file.
@@ -51,14 +91,30 @@ public:
     void resumeSave() override;
 
 protected slots:
+    void writePending();
+    void writeFinished();
     virtual void changeSetting(const Setting &setting, QVariant value) override;
     virtual void resetSetting(const Setting &setting) override;
 
 protected:
     virtual QVariant retrieveValue(const Setting &setting) override;
     void doSave();
+    /// Read the whole file if only a partial copy is loaded. Returns false if that failed, nothing may be written then.
+    bool ensureLoaded();
+    /// Read the whole file into contents
+    virtual bool readFile(INIFile &contents);
+    void updateStamp();
 
 protected:
     INIFile m_ini;
     QString m_filePath;
+    qint64 m_stamp = 0;
+    bool m_loaded = true;
+    QSet<QString> m_coveredKeys;
+
+    bool m_writeBehind = false;
+    bool m_dirty = false;
+    QTimer m_writeTimer;
+    QElapsedTimer m_dirtySince;
+    QFutureWatcher<qint64> m_writeWatcher;
 };
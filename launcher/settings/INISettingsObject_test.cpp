@@ -0,0 +1,75 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QFileInfo>
+
+#include "settings/INISettingsObject.h"
+#include "FileSystem.h"
+
+namespace {
+// stands in for a file that exists, but can't be read right now
+class UnreadableSettings : public INISettingsObject
+{
+public:
+    using INISettingsObject::INISettingsObject;
+    bool failReads = true;
+
+protected:
+    bool readFile(INIFile &contents) override
+    {
+        if(failReads)
+        {
+            return false;
+        }
+        return INISettingsObject::readFile(contents);
+    }
+};
+
+const QByteArray fullFile = "A=1\nB=2\n";
+}
+
+class INISettingsObjectTest : public QObject
+{
+    Q_OBJECT
+private:
+    // a settings object that only has A, like the instance summary gives it
+    std::unique_ptr<UnreadableSettings> partialSettings(const QString &path)
+    {
+        INIFile partial;
+        partial.set("A", "1");
+        std::unique_ptr<UnreadableSettings> settings(new UnreadableSettings(path, partial, QFileInfo(path).lastModified().toMSecsSinceEpoch()));
+        settings->deferLoading({"A"});
+        settings->registerSetting("A");
+        settings->registerSetting("B");
+        settings->registerSetting("C");
+        return settings;
+    }
+
+private slots:
+    void test_failedLoadDoesNotWrite()
+    {
+        QTemporaryDir dir;
+        auto path = FS::PathCombine(dir.path(), "instance.cfg");
+        FS::write(path, fullFile);
+
+        auto settings = partialSettings(path);
+        QCOMPARE(settings->get("A").toString(), QString("1"));
+        settings->set("C", "3");
+        settings->reset("A");
+        QVERIFY(!settings->isLoaded());
+        QCOMPARE(FS::read(path), fullFile);
+
+        // once the file can be read, writes go through and keep everything
+        settings->failReads = false;
+        settings->set("C", "3");
+        QVERIFY(settings->isLoaded());
+        INIFile written;
+        QVERIFY(written.loadFile(path));
+        QCOMPARE(written.get("A", QVariant()).toString(), QString("1"));
+        QCOMPARE(written.get("B", QVariant()).toString(), QString("2"));
+        QCOMPARE(written.get("C", QVariant()).toString(), QString("3"));
+    }
+};
+
+QTEST_GUILESS_MAIN(INISettingsObjectTest)
+
+#include "INISettingsObject_test.moc"
@@ -1,6 +1,11 @@
 #include "POTranslator.h"
 
 #include <QDebug>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QSaveFile>
+#include <cstring>
 #include "FileSystem.h"
 
 struct POEntry
@@ -9,14 +14,188 @@ struct POEntry
     bool fuzzy;
 };
 
+namespace {
+/*
+ * Compiled catalogs are a hash table that can be used straight from a memory mapped file:
+ *
+ * CatalogHeader
+ * quint32 buckets[bucketCount]         index + 1 of the entry in each bucket, 0 for empty ones
+ * CatalogEntry entries[entryCount]
+ * char keys[keysSize]                  "context|source" or "context|source@disambiguation", not terminated
+ * ushort texts[textsSize]              UTF-16 translations, aligned to 2 bytes
+ *
+ * Everything is in native byte order, catalogs are a cache and never leave the machine.
+ */
+const quint32 catalogMagic = 0x4D4D504F; // MMPO
+// bump when the format or the .po parser changes
+const quint32 catalogVersion = 1;
+
+struct CatalogHeader
+{
+    quint32 magic;
+    quint32 version;
+    qint64 sourceSize;
+    qint64 sourceModified;
+    quint32 entryCount;
+    quint32 bucketCount;
+    quint32 keysSize;
+    quint32 textsSize;
+};
+
+enum EntryFlags : quint32
+{
+    Fuzzy = 1,
+    // the key includes the disambiguation, it's looked up separately from the plain keys
+    Disambiguated = 2
+};
+
+struct CatalogEntry
+{
+    quint32 hash;
+    quint32 keyOffset;
+    quint32 keyLength;
+    quint32 textOffset;
+    quint32 textLength;
+    quint32 flags;
+};
+
+// FNV-1a, fed piece by piece so lookups don't have to build the key
+struct KeyHash
+{
+    quint32 value = 2166136261u;
+    void add(const char *data, int length)
+    {
+        for(int i = 0; i < length; i++)
+        {
+            value ^= uchar(data[i]);
+            value *= 16777619u;
+        }
+    }
+};
+
+struct KeyPiece
+{
+    const char *data;
+    int length;
+};
+
+quint32 hashPieces(const KeyPiece *pieces, int count)
+{
+    KeyHash hash;
+    for(int i = 0; i < count; i++)
+    {
+        hash.add(pieces[i].data, pieces[i].length);
+    }
+    return hash.value;
+}
+
+bool keyEquals(const char *key, quint32 keyLength, const KeyPiece *pieces, int count)
+{
+    quint32 offset = 0;
+    for(int i = 0; i < count; i++)
+    {
+        auto length = quint32(pieces[i].length);
+        if(offset + length > keyLength || memcmp(key + offset, pieces[i].data, length) != 0)
+        {
+            return false;
+        }
+        offset += length;
+    }
+    return offset == keyLength;
+}
+
+inline int alignTo2(int size)
+{
+    return (size + 1) & ~1;
+}
+
+QByteArray buildCatalog(const QFileInfo &source, const QHash<QByteArray, POEntry> &mapping, const QHash<QByteArray, POEntry> &mappingDisambiguation)
+{
+    QVector<CatalogEntry> entries;
+    QByteArray keys;
+    QVector<ushort> texts;
+    auto addEntries = [&](const QHash<QByteArray, POEntry> &from, quint32 flags)
+    {
+        for(auto iter = from.constBegin(); iter != from.constEnd(); iter++)
+        {
+            CatalogEntry entry;
+            KeyHash hash;
+            hash.add(iter.key().constData(), iter.key().size());
+            entry.hash = hash.value;
+            entry.keyOffset = keys.size();
+            entry.keyLength = iter.key().size();
+            entry.textOffset = texts.size();
+            entry.textLength = iter->text.size();
+            entry.flags = flags | (iter->fuzzy ? Fuzzy : 0);
+            keys.append(iter.key());
+            for(auto c: iter->text)
+            {
+                texts.append(c.unicode());
+            }
+            entries.append(entry);
+        }
+    };
+    addEntries(mapping, 0);
+    addEntries(mappingDisambiguation, Disambiguated);
+
+    quint32 bucketCount = 16;
+    while(bucketCount < quint32(entries.size()) * 2)
+    {
+        bucketCount *= 2;
+    }
+    QVector<quint32> buckets(bucketCount, 0);
+    for(int i = 0; i < entries.size(); i++)
+    {
+        auto index = entries[i].hash & (bucketCount - 1);
+        while(buckets[index])
+        {
+            index = (index + 1) & (bucketCount - 1);
+        }
+        buckets[index] = i + 1;
+    }
+
+    CatalogHeader header;
+    header.magic = catalogMagic;
+    header.version = catalogVersion;
+    header.sourceSize = source.size();
+    header.sourceModified = source.lastModified().toMSecsSinceEpoch();
+    header.entryCount = entries.size();
+    header.bucketCount = bucketCount;
+    header.keysSize = keys.size();
+    header.textsSize = texts.size();
+
+    QByteArray out;
+    out.append(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.append(reinterpret_cast<const char *>(buckets.constData()), buckets.size() * sizeof(quint32));
+    out.append(reinterpret_cast<const char *>(entries.constData()), entries.size() * sizeof(CatalogEntry));
+    out.append(keys);
+    out.resize(alignTo2(out.size()));
+    out.append(reinterpret_cast<const char *>(texts.constData()), texts.size() * sizeof(ushort));
+    return out;
+}
+}
+
 struct POTranslatorPrivate
 {
     QString filename;
-    QHash<QByteArray, POEntry> mapping;
-    QHash<QByteArray, POEntry> mapping_disambiguatrion;
+    QString catalogPath;
     bool loaded = false;
 
+    // the catalog is either mapped from catalogFile, or built in memory
+    QFile catalogFile;
+    QByteArray catalogData;
+    const uchar *data = nullptr;
+    CatalogHeader header;
+    const quint32 *buckets = nullptr;
+    const CatalogEntry *entries = nullptr;
+    const char *keys = nullptr;
+    const QChar *texts = nullptr;
+
     void reload();
+    bool parse(QHash<QByteArray, POEntry> &mapping, QHash<QByteArray, POEntry> &mappingDisambiguation);
+    bool mapCatalog(const QFileInfo &source);
+    bool useCatalog(const uchar *catalog, qint64 size, const QFileInfo &source);
+    const CatalogEntry *find(const KeyPiece *pieces, int count, quint32 flags) const;
 };
 
 class ParserArray : public QByteArray
@@ -153,13 +332,13 @@ public:
     }
 };
 
-void POTranslatorPrivate::reload()
+bool POTranslatorPrivate::parse(QHash<QByteArray, POEntry> &mapping, QHash<QByteArray, POEntry> &mappingDisambiguation)
 {
     QFile file(filename);
     if(!file.open(QFile::OpenMode::enum_type::ReadOnly | QFile::OpenMode::enum_type::Text))
     {
         qDebug() << "Failed to open PO file:" << filename;
-        return;
+        return false;
     }
 
     QByteArray context;
@@ -232,7 +411,7 @@ void POTranslatorPrivate::reload()
             {
                 case Mode::First:
                     qDebug() << "Unexpected escaped string during initial state... line:" << lineNumber;
-                    return;
+                    return false;
                 case Mode::MessageString:
                     out = &str;
                     break;
@@ -246,7 +425,7 @@ void POTranslatorPrivate::reload()
             if(!line.chompString(*out))
             {
                 qDebug() << "Badly formatted string on line:" << lineNumber;
-                return;
+                return false;
             }
         }
         else if(line.chomp("msgctxt ", 8))
@@ -261,7 +440,7 @@ void POTranslatorPrivate::reload()
                 case Mode::MessageContext:
                 case Mode::MessageId:
                     qDebug() << "Unexpected msgctxt line:" << lineNumber;
-                    return;
+                    return false;
             }
             if(line.chompString(context))
             {
@@ -286,7 +465,7 @@ void POTranslatorPrivate::reload()
                     break;
                 case Mode::MessageId:
                     qDebug() << "Unexpected msgid line:" << lineNumber;
-                    return;
+                    return false;
             }
             if(line.chompString(id))
             {
@@ -301,7 +480,7 @@ void POTranslatorPrivate::reload()
                 case Mode::MessageString:
                 case Mode::MessageContext:
                     qDebug() << "Unexpected msgstr line:" << lineNumber;
-                    return;
+                    return false;
                 case Mode::MessageId:
                     break;
             }
@@ -318,53 +497,200 @@ void POTranslatorPrivate::reload()
     }
     endEntry();
     mapping = std::move(newMapping);
-    mapping_disambiguatrion = std::move(newMapping_disambiguation);
+    mappingDisambiguation = std::move(newMapping_disambiguation);
+    return true;
+}
+
+bool POTranslatorPrivate::useCatalog(const uchar *catalog, qint64 size, const QFileInfo &source)
+{
+    if(size < qint64(sizeof(CatalogHeader)))
+    {
+        return false;
+    }
+    memcpy(&header, catalog, sizeof(CatalogHeader));
+    if(header.magic != catalogMagic || header.version != catalogVersion)
+    {
+        return false;
+    }
+    if(header.sourceSize != source.size() || header.sourceModified != source.lastModified().toMSecsSinceEpoch())
+    {
+        return false;
+    }
+    // the bucket count is a power of two, and everything has to add up to the size of the file
+    if(!header.bucketCount || (header.bucketCount & (header.bucketCount - 1)) || header.entryCount >= header.bucketCount)
+    {
+        return false;
+    }
+    qint64 keysStart = sizeof(CatalogHeader) + qint64(header.bucketCount) * sizeof(quint32) + qint64(header.entryCount) * sizeof(CatalogEntry);
+    qint64 textsStart = alignTo2(keysStart + header.keysSize);
+    if(textsStart + qint64(header.textsSize) * 2 != size)
+    {
+        return false;
+    }
+    auto catalogBuckets = reinterpret_cast<const quint32 *>(catalog + sizeof(CatalogHeader));
+    auto catalogEntries = reinterpret_cast<const CatalogEntry *>(catalogBuckets + header.bucketCount);
+    // lookups stop at an empty bucket, so there has to be one
+    quint32 usedBuckets = 0;
+    for(quint32 i = 0; i < header.bucketCount; i++)
+    {
+        if(catalogBuckets[i] > header.entryCount)
+        {
+            return false;
+        }
+        usedBuckets += catalogBuckets[i] ? 1 : 0;
+    }
+    if(usedBuckets > header.entryCount)
+    {
+        return false;
+    }
+    for(quint32 i = 0; i < header.entryCount; i++)
+    {
+        auto &entry = catalogEntries[i];
+        if(quint64(entry.keyOffset) + entry.keyLength > header.keysSize || quint64(entry.textOffset) + entry.textLength > header.textsSize)
+        {
+            return false;
+        }
+    }
+    data = catalog;
+    buckets = catalogBuckets;
+    entries = catalogEntries;
+    keys = reinterpret_cast<const char *>(catalog + keysStart);
+    texts = reinterpret_cast<const QChar *>(catalog + textsStart);
+    return true;
+}
+
+bool POTranslatorPrivate::mapCatalog(const QFileInfo &source)
+{
+    catalogFile.setFileName(catalogPath);
+    if(!catalogFile.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+    auto size = catalogFile.size();
+    auto mapped = catalogFile.map(0, size);
+    if(mapped && useCatalog(mapped, size, source))
+    {
+        return true;
+    }
+    if(mapped)
+    {
+        catalogFile.unmap(mapped);
+    }
+    catalogFile.close();
+    return false;
+}
+
+void POTranslatorPrivate::reload()
+{
+    QElapsedTimer timer;
+    timer.start();
+    QFileInfo source(filename);
+    if(!catalogPath.isEmpty() && mapCatalog(source))
+    {
+        loaded = true;
+        qDebug() << "Loaded compiled translations" << catalogPath << "in" << timer.elapsed() << "ms";
+        return;
+    }
+
+    QHash<QByteArray, POEntry> mapping;
+    QHash<QByteArray, POEntry> mappingDisambiguation;
+    if(!parse(mapping, mappingDisambiguation))
+    {
+        return;
+    }
+    catalogData = buildCatalog(source, mapping, mappingDisambiguation);
+    if(!useCatalog(reinterpret_cast<const uchar *>(catalogData.constData()), catalogData.size(), source))
+    {
+        qWarning() << "Failed to compile translations from" << filename;
+        return;
+    }
     loaded = true;
+    qDebug() << "Compiled translations from" << filename << "in" << timer.elapsed() << "ms";
+
+    if(catalogPath.isEmpty())
+    {
+        return;
+    }
+    QSaveFile output(catalogPath);
+    if(!FS::ensureFilePathExists(catalogPath) || !output.open(QIODevice::WriteOnly) || output.write(catalogData) != catalogData.size() || !output.commit())
+    {
+        qWarning() << "Couldn't save compiled translations to" << catalogPath;
+    }
+}
+
+const CatalogEntry *POTranslatorPrivate::find(const KeyPiece *pieces, int count, quint32 flags) const
+{
+    auto hash = hashPieces(pieces, count);
+    auto mask = header.bucketCount - 1;
+    for(auto index = hash & mask; buckets[index]; index = (index + 1) & mask)
+    {
+        auto &entry = entries[buckets[index] - 1];
+        if(entry.hash == hash && (entry.flags & Disambiguated) == flags && keyEquals(keys + entry.keyOffset, entry.keyLength, pieces, count))
+        {
+            return &entry;
+        }
+    }
+    return nullptr;
 }
 
-POTranslator::POTranslator(const QString& filename, QObject* parent) : QTranslator(parent)
+POTranslator::POTranslator(const QString& filename, const QString& catalogPath, QObject* parent) : QTranslator(parent)
 {
     d = new POTranslatorPrivate;
     d->filename = filename;
+    d->catalogPath = catalogPath;
     d->reload();
 }
 
+POTranslator::~POTranslator()
+{
+    delete d;
+}
+
 QString POTranslator::translate(const char* context, const char* sourceText, const char* disambiguation, int n) const
 {
+    if(!d->loaded || !sourceText)
+    {
+        return QString();
+    }
+    if(!context)
+    {
+        context = "";
+    }
+    KeyPiece pieces[] = {
+        {context, int(qstrlen(context))},
+        {"|", 1},
+        {sourceText, int(qstrlen(sourceText))},
+        {"@", 1},
+        {disambiguation, disambiguation ? int(qstrlen(disambiguation)) : 0}
+    };
+    const CatalogEntry *entry = nullptr;
     if(disambiguation)
     {
-        auto disambiguationKey = QByteArray(context) + "|" + QByteArray(sourceText) + "@" + QByteArray(disambiguation);
-        auto iter = d->mapping_disambiguatrion.find(disambiguationKey);
-        if(iter != d->mapping_disambiguatrion.end())
-        {
-            auto & entry = *iter;
-            if(entry.text.isEmpty())
-            {
-                qDebug() << "Translation entry has no content:" << disambiguationKey;
-            }
-            if(entry.fuzzy)
-            {
-                qDebug() << "Translation entry is fuzzy:" << disambiguationKey << "->" << entry.text;
-            }
-            return entry.text;
-        }
+        entry = d->find(pieces, 5, Disambiguated);
     }
-    auto key = QByteArray(context) + "|" + QByteArray(sourceText);
-    auto iter = d->mapping.find(key);
-    if(iter != d->mapping.end())
+    if(!entry)
     {
-        auto & entry = *iter;
-        if(entry.text.isEmpty())
-        {
-            qDebug() << "Translation entry has no content:" << key;
-        }
-        if(entry.fuzzy)
-        {
-            qDebug() << "Translation entry is fuzzy:" << key << "->" << entry.text;
-        }
-        return entry.text;
+        entry = d->find(pieces, 3, 0);
+    }
+    if(!entry)
+    {
+        return QString();
+    }
+    auto key = [&]()
+    {
+        return QByteArray(d->keys + entry->keyOffset, entry->keyLength);
+    };
+    if(!entry->textLength)
+    {
+        qDebug() << "Translation entry has no content:" << key();
+        return QString();
+    }
+    QString text(d->texts + entry->textOffset, entry->textLength);
+    if(entry->flags & Fuzzy)
+    {
+        qDebug() << "Translation entry is fuzzy:" << key() << "->" << text;
     }
-    return QString();
+    return text;
 }
 
 bool POTranslator::isEmpty() const
@@ -8,7 +8,14 @@ class POTranslator : public QTranslator
 {
     Q_OBJECT
 public:
-    explicit POTranslator(const QString& filename, QObject * parent = nullptr);
+    /**
+     * Load translations from the .po file at filename.
+     *
+     * The .po file is compiled into a hashed catalog, which is saved at catalogPath and memory mapped from there
+     * for as long as the .po file doesn't change. Without a catalogPath, the catalog only lives in memory.
+     */
+    explicit POTranslator(const QString& filename, const QString& catalogPath = QString(), QObject * parent = nullptr);
+    virtual ~POTranslator();
     QString translate(const char * context, const char * sourceText, const char * disambiguation, int n) const override;
     bool isEmpty() const override;
 private:
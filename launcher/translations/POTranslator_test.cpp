@@ -0,0 +1,216 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include "TestUtil.h"
+
+#include "translations/POTranslator.h"
+
+namespace {
+// about as many strings as the launcher has
+const int generatedCount = 2000;
+
+QByteArray samplePO()
+{
+    QByteArray po = R"(# Translation of the launcher
+msgid ""
+msgstr ""
+"Content-Type: text/plain; charset=UTF-8\n"
+"Language: de\n"
+
+msgctxt "MainWindow"
+msgid "Add Instance"
+msgstr "Instanz hinzufügen"
+
+msgctxt "MainWindow|toolbar"
+msgid "Settings"
+msgstr "Einstellungen (Leiste)"
+
+msgctxt "MainWindow"
+msgid "Settings"
+msgstr "Einstellungen"
+
+msgctxt "MainWindow"
+msgid "Untranslated"
+msgstr ""
+
+msgctxt "Dialog"
+msgid ""
+"Multi\n"
+"line"
+msgstr "Mehr\nzeilig \"zitiert\"\t\\"
+
+)";
+    for(int i = 0; i < generatedCount; i++)
+    {
+        po += QString("msgctxt \"Page%1\"\nmsgid \"String %2\"\nmsgstr \"Zeichenkette %2\"\n\n").arg(i % 40).arg(i).toUtf8();
+    }
+    return po;
+}
+
+QString generatedContext(int i)
+{
+    return QString("Page%1").arg(i % 40);
+}
+}
+
+class POTranslatorTest : public QObject
+{
+    Q_OBJECT
+
+    QTemporaryDir m_dir;
+    QString m_poPath;
+
+    QString catalogPath(bool cached)
+    {
+        return cached ? m_dir.filePath("de.mmcpo") : QString();
+    }
+
+private
+slots:
+    void initTestCase()
+    {
+        QVERIFY(m_dir.isValid());
+        m_poPath = m_dir.filePath("de.po");
+        QFile file(m_poPath);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(samplePO());
+    }
+
+    void test_translate_data()
+    {
+        QTest::addColumn<bool>("cached");
+        QTest::addColumn<QByteArray>("context");
+        QTest::addColumn<QByteArray>("source");
+        QTest::addColumn<QByteArray>("disambiguation");
+        QTest::addColumn<QString>("expected");
+
+        for(bool cached: {false, true})
+        {
+            // the first catalog row compiles the catalog, the rest map it
+            QString mode = cached ? "catalog" : "memory";
+            QTest::newRow(qPrintable(mode + ", plain")) << cached << QByteArray("MainWindow") << QByteArray("Add Instance") << QByteArray() << QString::fromUtf8("Instanz hinzufügen");
+            QTest::newRow(qPrintable(mode + ", overwritten")) << cached << QByteArray("MainWindow") << QByteArray("Settings") << QByteArray() << QString("Einstellungen");
+            QTest::newRow(qPrintable(mode + ", disambiguated")) << cached << QByteArray("MainWindow") << QByteArray("Settings") << QByteArray("toolbar") << QString("Einstellungen (Leiste)");
+            QTest::newRow(qPrintable(mode + ", unknown disambiguation")) << cached << QByteArray("MainWindow") << QByteArray("Settings") << QByteArray("menu") << QString("Einstellungen");
+            QTest::newRow(qPrintable(mode + ", empty")) << cached << QByteArray("MainWindow") << QByteArray("Untranslated") << QByteArray() << QString();
+            QTest::newRow(qPrintable(mode + ", missing")) << cached << QByteArray("MainWindow") << QByteArray("Missing") << QByteArray() << QString();
+            QTest::newRow(qPrintable(mode + ", multi-line")) << cached << QByteArray("Dialog") << QByteArray("Multi\nline") << QByteArray() << QString("Mehr\nzeilig \"zitiert\"\t\\");
+            QTest::newRow(qPrintable(mode + ", partial key")) << cached << QByteArray("Dialog") << QByteArray("Multi") << QByteArray() << QString();
+            QTest::newRow(qPrintable(mode + ", generated")) << cached << QByteArray("Page7") << QByteArray("String 1287") << QByteArray() << QString("Zeichenkette 1287");
+            QTest::newRow(qPrintable(mode + ", wrong context")) << cached << QByteArray("Page8") << QByteArray("String 1287") << QByteArray() << QString();
+        }
+    }
+    void test_translate()
+    {
+        QFETCH(bool, cached);
+        QFETCH(QByteArray, context);
+        QFETCH(QByteArray, source);
+        QFETCH(QByteArray, disambiguation);
+        QFETCH(QString, expected);
+
+        POTranslator translator(m_poPath, catalogPath(cached));
+        QVERIFY(!translator.isEmpty());
+        auto result = translator.translate(context.constData(), source.constData(), disambiguation.isNull() ? nullptr : disambiguation.constData(), -1);
+        QCOMPARE(result, expected);
+        QCOMPARE(result.isNull(), expected.isNull());
+    }
+
+    void test_staleCatalog()
+    {
+        QTemporaryDir dir;
+        auto poPath = dir.filePath("fr.po");
+        auto catalog = dir.filePath("fr.mmcpo");
+        {
+            QFile file(poPath);
+            QVERIFY(file.open(QIODevice::WriteOnly));
+            file.write("msgctxt \"A\"\nmsgid \"Yes\"\nmsgstr \"Oui\"\n");
+        }
+        {
+            POTranslator translator(poPath, catalog);
+            QCOMPARE(translator.translate("A", "Yes", nullptr, -1), QString("Oui"));
+        }
+        QVERIFY(QFileInfo::exists(catalog));
+        {
+            QFile file(poPath);
+            QVERIFY(file.open(QIODevice::WriteOnly));
+            file.write("msgctxt \"A\"\nmsgid \"Yes\"\nmsgstr \"Oui oui\"\n");
+        }
+        POTranslator translator(poPath, catalog);
+        QCOMPARE(translator.translate("A", "Yes", nullptr, -1), QString("Oui oui"));
+    }
+
+    void test_damagedCatalog()
+    {
+        auto catalog = m_dir.filePath("damaged.mmcpo");
+        {
+            POTranslator translator(m_poPath, catalog);
+        }
+        QFile file(catalog);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        file.resize(file.size() / 2);
+        file.close();
+        POTranslator translator(m_poPath, catalog);
+        QCOMPARE(translator.translate("MainWindow", "Add Instance", nullptr, -1), QString::fromUtf8("Instanz hinzufügen"));
+    }
+
+    void test_startup_data()
+    {
+        QTest::addColumn<bool>("cached");
+        QTest::newRow("parse .po") << false;
+        QTest::newRow("mapped catalog") << true;
+    }
+    void test_startup()
+    {
+        QFETCH(bool, cached);
+        auto catalog = catalogPath(cached);
+        if(cached)
+        {
+            POTranslator warmup(m_poPath, catalog);
+        }
+        QBENCHMARK
+        {
+            POTranslator translator(m_poPath, catalog);
+            QVERIFY(!translator.isEmpty());
+        }
+    }
+
+    void test_lookup_data()
+    {
+        QTest::addColumn<bool>("reference");
+        QTest::newRow("QHash with built keys") << true;
+        QTest::newRow("catalog") << false;
+    }
+    void test_lookup()
+    {
+        QFETCH(bool, reference);
+        QList<QByteArray> contexts, sources;
+        QHash<QByteArray, QString> mapping;
+        for(int i = 0; i < generatedCount; i++)
+        {
+            contexts.append(generatedContext(i).toUtf8());
+            sources.append(QString("String %1").arg(i).toUtf8());
+            mapping.insert(contexts.last() + "|" + sources.last(), QString("Zeichenkette %1").arg(i));
+        }
+        POTranslator translator(m_poPath, catalogPath(true));
+        QBENCHMARK
+        {
+            for(int i = 0; i < generatedCount; i++)
+            {
+                auto context = contexts[i].constData();
+                auto source = sources[i].constData();
+                if(reference)
+                {
+                    // what every lookup used to do
+                    mapping.value(QByteArray(context) + "|" + QByteArray(source));
+                }
+                else
+                {
+                    translator.translate(context, source, nullptr, -1);
+                }
+            }
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(POTranslatorTest)
+
+#include "POTranslator_test.moc"
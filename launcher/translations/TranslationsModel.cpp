@@ -499,7 +499,9 @@ bool TranslationsModel::selectLanguage(QString key)
     if(langPtr->localFileType == FileType::PO)
     {
         qDebug() << "Loading Application Language File for" << langCode.toLocal8Bit().constData() << "...";
-        auto poTranslator = new POTranslator(FS::PathCombine(d->m_dir.path(), langCode + ".po"));
+        // compiled catalogs go to the cache, writing them next to the .po files would set off the folder watcher
+        auto catalogPath = FS::PathCombine(QDir("cache/translations").absolutePath(), langCode + ".mmcpo");
+        auto poTranslator = new POTranslator(FS::PathCombine(d->m_dir.path(), langCode + ".po"), catalogPath);
         if(!poTranslator->isEmpty())
         {
             if (!QCoreApplication::installTranslator(poTranslator))
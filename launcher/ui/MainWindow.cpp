@@ -865,6 +865,18 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), ui(new MainWindow
     }
 
     setSelectedInstanceById(APPLICATION->settings()->get("SelectedInstance").toString());
+    if(APPLICATION->instances()->isLoading())
+    {
+        // the instance might not be loaded yet
+        connect(APPLICATION->instances().get(), &InstanceList::instancesLoaded, this, [this]()
+        {
+            if(!m_selectedInstance)
+            {
+                setSelectedInstanceById(APPLICATION->settings()->get("SelectedInstance").toString());
+            }
+            updateStatusCenter();
+        });
+    }
 
     // removing this looks stupid
     view->setFocus();
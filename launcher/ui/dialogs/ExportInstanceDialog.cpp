@@ -30,6 +30,7 @@
 #include "Application.h"
 #include <icons/IconList.h>
 #include <FileSystem.h>
+#include "settings/INISettingsObject.h"
 
 class PackIgnoreProxy : public QSortFilterProxyModel
 {
@@ -400,6 +401,7 @@ bool ExportInstanceDialog::doExport()
     }
 
     SaveIcon(m_instance);
+    INISettingsObject::flushAll();
 
     auto & blocked = proxyModel->blockedPaths();
     using std::placeholders::_1;
@@ -52,6 +52,9 @@ static void viewItemTextLayout(QTextLayout &textLayout, int lineWidth, qreal &he
 
 ListViewDelegate::ListViewDelegate(QObject *parent) : QStyledItemDelegate(parent)
 {
+    // enough for the names of a lot of instances and their icons in a few states
+    m_textCache.setMaxCost(2000);
+    m_iconCache.setMaxCost(16 * 1024);
 }
 
 void drawSelectionRect(QPainter *painter, const QStyleOptionViewItem &option,
@@ -111,9 +114,9 @@ void drawProgressOverlay(QPainter *painter, const QStyleOptionViewItem &option,
     painter->restore();
 }
 
-void drawBadges(QPainter *painter, const QStyleOptionViewItem &option, BaseInstance *instance, QIcon::Mode mode, QIcon::State state)
+QStringList instanceBadges(BaseInstance *instance)
 {
-    QList<QString> pixmaps;
+    QStringList pixmaps;
     if (instance->isRunning())
     {
         pixmaps.append("status-running");
@@ -126,13 +129,17 @@ void drawBadges(QPainter *painter, const QStyleOptionViewItem &option, BaseInsta
     {
         pixmaps.append("checkupdate");
     }
+    return pixmaps;
+}
 
+void drawBadges(QPainter *painter, const QRect &rect, const QStringList &pixmaps, QIcon::Mode mode, QIcon::State state)
+{
     static const int itemSide = 24;
     static const int spacing = 1;
-    const int itemsPerRow = qMax(1, qFloor(double(option.rect.width() + spacing) / double(itemSide + spacing)));
+    const int itemsPerRow = qMax(1, qFloor(double(rect.width() + spacing) / double(itemSide + spacing)));
     const int rows = qCeil((double)pixmaps.size() / (double)itemsPerRow);
     QListIterator<QString> it(pixmaps);
-    painter->translate(option.rect.topLeft());
+    painter->translate(rect.topLeft());
     for (int y = 0; y < rows; ++y)
     {
         for (int x = 0; x < itemsPerRow; ++x)
@@ -147,7 +154,7 @@ void drawBadges(QPainter *painter, const QStyleOptionViewItem &option, BaseInsta
             const QPixmap pixmap;
             // itemSide
             QRect badgeRect(
-                option.rect.width() - x * itemSide + qMax(x - 1, 0) * spacing - itemSide,
+                rect.width() - x * itemSide + qMax(x - 1, 0) * spacing - itemSide,
                 y * itemSide + qMax(y - 1, 0) * spacing,
                 itemSide,
                 itemSide
@@ -155,24 +162,59 @@ void drawBadges(QPainter *painter, const QStyleOptionViewItem &option, BaseInsta
             icon.paint(painter, badgeRect, Qt::AlignCenter, mode, state);
         }
     }
-    painter->translate(-option.rect.topLeft());
+    painter->translate(-rect.topLeft());
 }
 
-static QSize viewItemTextSize(const QStyleOptionViewItem *option)
+const ListViewDelegate::LaidOutText *ListViewDelegate::layoutText(const QStyleOptionViewItem &opt, int width) const
 {
-    QStyle *style = option->widget ? option->widget->style() : QApplication::style();
+    // the text goes last, so nothing in it can be mistaken for the rest of the key
+    const QString key = opt.font.key() + '\n' + QString::number(width) + '\n' + QString::number(int(opt.direction)) + '\n' + opt.text;
+    auto cached = m_textCache.object(key);
+    if (cached)
+    {
+        return cached;
+    }
+    cached = new LaidOutText;
     QTextOption textOption;
     textOption.setWrapMode(QTextOption::WrapAtWordBoundaryOrAnywhere);
-    QTextLayout textLayout;
-    textLayout.setTextOption(textOption);
-    textLayout.setFont(option->font);
-    textLayout.setText(option->text);
-    const int textMargin = style->pixelMetric(QStyle::PM_FocusFrameHMargin, option, option->widget) + 1;
-    QRect bounds(0, 0, 100 - 2 * textMargin, 600);
-    qreal height = 0, widthUsed = 0;
-    viewItemTextLayout(textLayout, bounds.width(), height, widthUsed);
-    const QSize size(qCeil(widthUsed), qCeil(height));
-    return QSize(size.width() + 2 * textMargin, size.height());
+    textOption.setTextDirection(opt.direction);
+    textOption.setAlignment(QStyle::visualAlignment(opt.direction, opt.displayAlignment));
+    cached->layout.setTextOption(textOption);
+    cached->layout.setFont(opt.font);
+    cached->layout.setText(opt.text);
+    viewItemTextLayout(cached->layout, width, cached->height, cached->widthUsed);
+    m_textCache.insert(key, cached);
+    return cached;
+}
+
+QPixmap ListViewDelegate::iconWithBadges(const QStyleOptionViewItem &opt, const QSize &size, qreal devicePixelRatio,
+                                         const QStringList &badges, QIcon::Mode mode, QIcon::State state) const
+{
+    const QString key = QString("%1 %2x%3@%4 %5 %6 ")
+        .arg(opt.icon.cacheKey())
+        .arg(size.width())
+        .arg(size.height())
+        .arg(devicePixelRatio)
+        .arg(int(mode))
+        .arg(int(state)) + badges.join(',');
+    auto cached = m_iconCache.object(key);
+    if (cached)
+    {
+        return *cached;
+    }
+    QPixmap pixmap(size * devicePixelRatio);
+    pixmap.setDevicePixelRatio(devicePixelRatio);
+    pixmap.fill(Qt::transparent);
+    {
+        QPainter painter(&pixmap);
+        painter.setRenderHint(QPainter::SmoothPixmapTransform);
+        const QRect iconbox(QPoint(0, 0), size);
+        opt.icon.paint(&painter, iconbox, Qt::AlignCenter, mode, state);
+        drawBadges(&painter, iconbox, badges, mode, state);
+    }
+    const int cost = qMax(1, pixmap.width() * pixmap.height() * pixmap.depth() / 8 / 1024);
+    m_iconCache.insert(key, new QPixmap(pixmap), cost);
+    return pixmap;
 }
 
 void ListViewDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option,
@@ -203,8 +245,6 @@ void ListViewDelegate::paint(QPainter *painter, const QStyleOptionViewItem &opti
 
     // draw background
     {
-        // FIXME: unused
-        // QSize textSize = viewItemTextSize ( &opt );
         drawSelectionRect(painter, opt, textHighlightRect);
         /*
         QPalette::ColorGroup cg;
@@ -270,10 +310,18 @@ void ListViewDelegate::paint(QPainter *painter, const QStyleOptionViewItem &opti
         mode = QIcon::Selected;
     QIcon::State state = opt.state & QStyle::State_Open ? QIcon::On : QIcon::Off;
 
-    // draw the icon
+    // draw the icon, with the badges on top of it
     {
         iconbox.setHeight(iconSize);
-        opt.icon.paint(painter, iconbox, Qt::AlignCenter, mode, state);
+        // FIXME: this really has no business of being here. Make generic.
+        QStringList badges;
+        auto instance = (BaseInstance*)index.data(InstanceList::InstancePointerRole)
+                .value<void *>();
+        if (instance)
+        {
+            badges = instanceBadges(instance);
+        }
+        painter->drawPixmap(iconbox.topLeft(), iconWithBadges(opt, iconbox.size(), painter->device()->devicePixelRatioF(), badges, mode, state));
     }
     // set the text colors
     QPalette::ColorGroup cg =
@@ -290,37 +338,18 @@ void ListViewDelegate::paint(QPainter *painter, const QStyleOptionViewItem &opti
     }
 
     // draw the text
-    QTextOption textOption;
-    textOption.setWrapMode(QTextOption::WrapAtWordBoundaryOrAnywhere);
-    textOption.setTextDirection(opt.direction);
-    textOption.setAlignment(QStyle::visualAlignment(opt.direction, opt.displayAlignment));
-    QTextLayout textLayout;
-    textLayout.setTextOption(textOption);
-    textLayout.setFont(opt.font);
-    textLayout.setText(opt.text);
-
-    qreal width, height;
-    viewItemTextLayout(textLayout, textRect.width(), height, width);
-
-    const int lineCount = textLayout.lineCount();
+    auto text = layoutText(opt, textRect.width());
+    const int lineCount = text->layout.lineCount();
 
     const QRect layoutRect = QStyle::alignedRect(
-        opt.direction, opt.displayAlignment, QSize(textRect.width(), int(height)), textRect);
+        opt.direction, opt.displayAlignment, QSize(textRect.width(), int(text->height)), textRect);
     const QPointF position = layoutRect.topLeft();
     for (int i = 0; i < lineCount; ++i)
     {
-        const QTextLine line = textLayout.lineAt(i);
+        const QTextLine line = text->layout.lineAt(i);
         line.draw(painter, position);
     }
 
-    // FIXME: this really has no business of being here. Make generic.
-    auto instance = (BaseInstance*)index.data(InstanceList::InstancePointerRole)
-            .value<void *>();
-    if (instance)
-    {
-        drawBadges(painter, opt, instance, mode, state);
-    }
-
     drawProgressOverlay(painter, opt, index.data(InstanceViewRoles::ProgressValueRole).toInt(),
                         index.data(InstanceViewRoles::ProgressMaximumRole).toInt());
 
@@ -340,8 +369,7 @@ QSize ListViewDelegate::sizeHint(const QStyleOptionViewItem &option,
     QStyle *style = opt.widget ? opt.widget->style() : QApplication::style();
     const int textMargin = style->pixelMetric(QStyle::PM_FocusFrameHMargin, &option, opt.widget) + 1;
     int height = 48 + textMargin * 2 + 5; // TODO: turn constants into variables
-    QSize szz = viewItemTextSize(&opt);
-    height += szz.height();
+    height += qCeil(layoutText(opt, 100 - 2 * textMargin)->height);
     // FIXME: maybe the icon items could scale and keep proportions?
     QSize sz(100, height);
     return sz;
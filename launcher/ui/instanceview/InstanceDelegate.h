@@ -17,6 +17,8 @@
 
 #include <QStyledItemDelegate>
 #include <QCache>
+#include <QTextLayout>
+#include <QPixmap>
 
 class ListViewDelegate : public QStyledItemDelegate
 {
@@ -36,4 +38,23 @@ public:
 
 private slots:
     void editingDone();
+
+private:
+    struct LaidOutText
+    {
+        QTextLayout layout;
+        qreal height = 0;
+        qreal widthUsed = 0;
+    };
+    /// the text of opt, broken into lines of the given width
+    const LaidOutText *layoutText(const QStyleOptionViewItem &opt, int width) const;
+    /// the icon of opt with the badges drawn over it
+    QPixmap iconWithBadges(const QStyleOptionViewItem &opt, const QSize &size, qreal devicePixelRatio,
+                           const QStringList &badges, QIcon::Mode mode, QIcon::State state) const;
+
+private:
+    // Everything that goes into an entry is part of its key, so changed names, icons or states simply miss.
+    mutable QCache<QString, LaidOutText> m_textCache;
+    // cost is in KiB
+    mutable QCache<QString, QPixmap> m_iconCache;
 };
@@ -23,9 +23,10 @@
 #include <QPersistentModelIndex>
 #include <QDrag>
 #include <QMimeData>
-#include <QCache>
 #include <QScrollBar>
 #include <QAccessible>
+#include <QPaintEvent>
+#include <algorithm>
 
 #include "VisualGroup.h"
 #include <QDebug>
@@ -161,21 +162,21 @@ void InstanceView::updateScrollbar()
 
 void InstanceView::updateGeometries()
 {
-    geometryCache.clear();
-
     QMap<LocaleString, VisualGroup *> cats;
+    QHash<QString, QList<QModelIndex>> groupItems;
 
+    // sort the items into groups in one pass over the model
     for (int i = 0; i < model()->rowCount(); ++i)
     {
-        const QString groupName = model()->index(i, 0).data(InstanceViewRoles::GroupRole).toString();
+        const QModelIndex index = model()->index(i, 0);
+        const QString groupName = index.data(InstanceViewRoles::GroupRole).toString();
+        groupItems[groupName].append(index);
         if (!cats.contains(groupName))
         {
             VisualGroup *old = this->category(groupName);
             if (old)
             {
-                auto cat = new VisualGroup(old);
-                cats.insert(groupName, cat);
-                cat->update();
+                cats.insert(groupName, new VisualGroup(old));
             }
             else
             {
@@ -184,17 +185,53 @@ void InstanceView::updateGeometries()
                     cat->collapsed = fVisibility(groupName);
                 }
                 cats.insert(groupName, cat);
-                cat->update();
             }
         }
     }
+    for (auto cat : cats)
+    {
+        cat->update(groupItems[cat->text]);
+    }
 
     qDeleteAll(m_groups);
     m_groups = cats.values();
+    m_groupsByName.clear();
+    for (auto cat : m_groups)
+    {
+        m_groupsByName.insert(cat->text, cat);
+    }
     updateScrollbar();
+    updateItemGeometry();
     viewport()->update();
 }
 
+void InstanceView::updateItemGeometry()
+{
+    m_itemGeometry = QVector<QRect>(model()->rowCount());
+    for (auto cat : m_groups)
+    {
+        if (cat->collapsed)
+        {
+            continue;
+        }
+        int top = cat->verticalPosition() + cat->headerHeight() + 5;
+        for (auto & row : cat->rows)
+        {
+            for (int x = 0; x < row.size(); x++)
+            {
+                int modelRow = row.items[x].row();
+                if (modelRow < 0 || modelRow >= m_itemGeometry.size())
+                {
+                    continue;
+                }
+                QRect out(m_spacing + x * (itemWidth() + m_spacing), top + row.top, 0, 0);
+                out.setSize(row.sizes[x]);
+                m_itemGeometry[modelRow] = out;
+            }
+        }
+    }
+}
+
 bool InstanceView::isIndexHidden(const QModelIndex &index) const
 {
     VisualGroup *cat = category(index);
@@ -215,28 +252,68 @@ VisualGroup *InstanceView::category(const QModelIndex &index) const
 
 VisualGroup *InstanceView::category(const QString &cat) const
 {
-    for (auto group : m_groups)
+    return m_groupsByName.value(cat, nullptr);
+}
+
+VisualGroup *InstanceView::categoryAt(const QPoint &pos, VisualGroup::HitResults & result) const
+{
+    // groups above pos can't be hit, and if this one isn't, the ones below aren't either
+    int i = firstGroupEndingAfter(pos.y());
+    if (i < m_groups.size())
     {
-        if (group->text == cat)
+        result = m_groups[i]->hitScan(pos);
+        if(result != VisualGroup::NoHit)
         {
-            return group;
+            return m_groups[i];
         }
     }
+    result = VisualGroup::NoHit;
     return nullptr;
 }
 
-VisualGroup *InstanceView::categoryAt(const QPoint &pos, VisualGroup::HitResults & result) const
+int InstanceView::firstGroupEndingAfter(int y) const
 {
-    for (auto group : m_groups)
+    auto iter = std::upper_bound(m_groups.constBegin(), m_groups.constEnd(), y, [](int y, const VisualGroup *group)
     {
-        result = group->hitScan(pos);
-        if(result != VisualGroup::NoHit)
+        return y < group->verticalPosition() + group->totalHeight();
+    });
+    return iter - m_groups.constBegin();
+}
+
+void InstanceView::forEachItemIn(const QRect &rect, std::function<void(const QModelIndex &, const QRect &)> f) const
+{
+    for (int i = firstGroupEndingAfter(rect.top()); i < m_groups.size(); i++)
+    {
+        const VisualGroup *group = m_groups[i];
+        if (group->verticalPosition() > rect.bottom())
+        {
+            break;
+        }
+        if (group->collapsed)
+        {
+            continue;
+        }
+        int bodyTop = group->verticalPosition() + group->headerHeight() + 5;
+        auto row = std::upper_bound(group->rows.constBegin(), group->rows.constEnd(), rect.top() - bodyTop, [](int y, const VisualRow &row)
+        {
+            return y < row.top + row.height;
+        });
+        for (; row != group->rows.constEnd() && bodyTop + row->top <= rect.bottom(); row++)
         {
-            return group;
+            for (auto & index : row->items)
+            {
+                if (index.row() >= m_itemGeometry.size())
+                {
+                    continue;
+                }
+                const QRect &itemRect = m_itemGeometry[index.row()];
+                if (itemRect.intersects(rect))
+                {
+                    f(index, itemRect);
+                }
+            }
         }
     }
-    result = VisualGroup::NoHit;
-    return nullptr;
 }
 
 QString InstanceView::groupNameAt(const QPoint &point)
@@ -477,11 +554,18 @@ void InstanceView::paintEvent(QPaintEvent *event)
     QStyleOptionViewItem option(viewOptions());
     option.widget = this;
 
+    // only what intersects the exposed area needs to be painted
+    const QRect exposed = event->rect().translated(offset());
+
     int wpWidth = viewport()->width();
     option.rect.setWidth(wpWidth);
-    for (int i = 0; i < m_groups.size(); ++i)
+    for (int i = firstGroupEndingAfter(exposed.top()); i < m_groups.size(); ++i)
     {
         VisualGroup *category = m_groups.at(i);
+        if (category->verticalPosition() > exposed.bottom())
+        {
+            break;
+        }
         int y = category->verticalPosition();
         y -= verticalOffset();
         QRect backup = option.rect;
@@ -495,32 +579,33 @@ void InstanceView::paintEvent(QPaintEvent *event)
         option.rect = backup;
     }
 
-    for (int i = 0; i < model()->rowCount(); ++i)
+    option.features |= QStyleOptionViewItem::WrapText;
+    // every item starts from the same state, so it doesn't depend on which items were painted before it
+    const QStyle::State baseState = option.state;
+    const QModelIndex current = currentIndex();
+    forEachItemIn(exposed, [&](const QModelIndex &index, const QRect &rect)
     {
-        const QModelIndex index = model()->index(i, 0);
-        if (isIndexHidden(index))
-        {
-            continue;
-        }
         Qt::ItemFlags flags = index.flags();
-        option.rect = visualRect(index);
-        option.features |= QStyleOptionViewItem::WrapText;
+        option.rect = rect.translated(-offset());
+        option.state = baseState;
         if (flags & Qt::ItemIsSelectable && selectionModel()->isSelected(index))
         {
-            option.state |= selectionModel()->isSelected(index) ? QStyle::State_Selected
-                                                                : QStyle::State_None;
+            option.state |= QStyle::State_Selected;
         }
         else
         {
             option.state &= ~QStyle::State_Selected;
         }
-        option.state |= (index == currentIndex()) ? QStyle::State_HasFocus : QStyle::State_None;
+        if (index == current)
+        {
+            option.state |= QStyle::State_HasFocus;
+        }
         if (!(flags & Qt::ItemIsEnabled))
         {
             option.state &= ~QStyle::State_Enabled;
         }
         itemDelegate()->paint(&painter, option, index);
-    }
+    });
 
     /*
      * Drop indicators for manual reordering...
@@ -693,59 +778,34 @@ QRect InstanceView::geometryRect(const QModelIndex &index) const
 {
     const_cast<InstanceView*>(this)->executeDelayedItemsLayout();
 
-    if (!index.isValid() || isIndexHidden(index) || index.column() > 0)
+    if (!index.isValid() || index.column() > 0 || index.row() >= m_itemGeometry.size())
     {
         return QRect();
     }
-
-    int row = index.row();
-    if(geometryCache.contains(row))
-    {
-        return *geometryCache[row];
-    }
-
-    const VisualGroup *cat = category(index);
-    QPair<int, int> pos = cat->positionOf(index);
-    int x = pos.first;
-    // int y = pos.second;
-
-    QRect out;
-    out.setTop(cat->verticalPosition() + cat->headerHeight() + 5 + cat->rowTopOf(index));
-    out.setLeft(m_spacing + x * (itemWidth() + m_spacing));
-    out.setSize(itemDelegate()->sizeHint(viewOptions(), index));
-    geometryCache.insert(row, new QRect(out));
-    return out;
+    return m_itemGeometry[index.row()];
 }
 
 QModelIndex InstanceView::indexAt(const QPoint &point) const
 {
     const_cast<InstanceView*>(this)->executeDelayedItemsLayout();
 
-    for (int i = 0; i < model()->rowCount(); ++i)
+    QModelIndex found;
+    forEachItemIn(QRect(point + offset(), QSize(1, 1)), [&](const QModelIndex &index, const QRect &)
     {
-        QModelIndex index = model()->index(i, 0);
-        if (visualRect(index).contains(point))
-        {
-            return index;
-        }
-    }
-    return QModelIndex();
+        found = index;
+    });
+    return found;
 }
 
 void InstanceView::setSelection(const QRect &rect, const QItemSelectionModel::SelectionFlags commands)
 {
     executeDelayedItemsLayout();
 
-    for (int i = 0; i < model()->rowCount(); ++i)
+    forEachItemIn(rect.normalized().translated(offset()), [&](const QModelIndex &index, const QRect &itemRect)
     {
-        QModelIndex index = model()->index(i, 0);
-        QRect itemRect = visualRect(index);
-        if (itemRect.intersects(rect))
-        {
-            selectionModel()->select(index, commands);
-            update(itemRect.translated(-offset()));
-        }
-    }
+        selectionModel()->select(index, commands);
+        viewport()->update(itemRect.translated(-offset()));
+    });
 }
 
 QPixmap InstanceView::renderToPixmap(const QModelIndexList &indices, QRect *r) const
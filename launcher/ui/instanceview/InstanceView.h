@@ -18,7 +18,7 @@
 #include <QListView>
 #include <QLineEdit>
 #include <QScrollBar>
-#include <QCache>
+#include <QHash>
 #include "VisualGroup.h"
 #include <functional>
 
@@ -105,7 +105,9 @@ protected:
 
 private:
     friend struct VisualGroup;
+    // sorted by vertical position
     QList<VisualGroup *> m_groups;
+    QHash<QString, VisualGroup *> m_groupsByName;
 
     visibilityFunction fVisibility;
 
@@ -118,7 +120,8 @@ private:
     int m_itemWidth = 100;
     int m_currentItemsPerRow = -1;
     int m_currentCursorColumn= -1;
-    mutable QCache<int, QRect> geometryCache;
+    // geometry rectangle of each model row, empty for items in collapsed groups
+    QVector<QRect> m_itemGeometry;
 
     // point where the currently active mouse action started in geometry coordinates
     QPoint m_pressedPosition;
@@ -131,6 +134,10 @@ private:
     VisualGroup *category(const QModelIndex &index) const;
     VisualGroup *category(const QString &cat) const;
     VisualGroup *categoryAt(const QPoint &pos, VisualGroup::HitResults & result) const;
+    /// index of the first group that ends below y, in geometry coordinates
+    int firstGroupEndingAfter(int y) const;
+    /// call f for every visible item intersecting rect, in geometry coordinates
+    void forEachItemIn(const QRect &rect, std::function<void(const QModelIndex &, const QRect &)> f) const;
 
     int itemsPerRow() const
     {
@@ -141,6 +148,7 @@ private:
 private: /* methods */
     int itemWidth() const;
     int calculateItemsPerRow() const;
+    void updateItemGeometry();
     int verticalScrollToValue(const QModelIndex &index, const QRect &rect, QListView::ScrollHint hint) const;
     QPixmap renderToPixmap(const QModelIndexList &indices, QRect *r) const;
     QList<QPair<QRect, QModelIndex>> draggablePaintPairs(const QModelIndexList &indices, QRect *r) const;
@@ -0,0 +1,150 @@
+#include <QTest>
+#include <QApplication>
+#include <QStandardItemModel>
+#include <QStyledItemDelegate>
+#include <QPixmap>
+#include <QScrollBar>
+
+#include "ui/instanceview/InstanceView.h"
+#include "ui/instanceview/InstanceDelegate.h"
+
+namespace {
+// fixed size items, remembers what it was asked to paint
+class CountingDelegate : public QStyledItemDelegate
+{
+public:
+    void paint(QPainter *, const QStyleOptionViewItem &option, const QModelIndex &index) const override
+    {
+        painted.append(qMakePair(index, option.rect));
+    }
+    QSize sizeHint(const QStyleOptionViewItem &, const QModelIndex &) const override
+    {
+        return QSize(100, 80);
+    }
+    mutable QList<QPair<QModelIndex, QRect>> painted;
+};
+
+void fillModel(QStandardItemModel &model, int count, int groups)
+{
+    model.clear();
+    for (int i = 0; i < count; i++)
+    {
+        auto item = new QStandardItem(QString("Instance %1 with a name long enough to wrap").arg(i));
+        item->setData(QString("Group %1").arg(i % groups), InstanceViewRoles::GroupRole);
+        model.appendRow(item);
+    }
+}
+}
+
+class InstanceViewTest : public QObject
+{
+    Q_OBJECT
+private
+slots:
+    void test_geometry()
+    {
+        QStandardItemModel model;
+        fillModel(model, 200, 10);
+        CountingDelegate delegate;
+        InstanceView view;
+        view.setItemDelegate(&delegate);
+        view.setModel(&model);
+        view.resize(640, 480);
+        view.show();
+        QVERIFY(QTest::qWaitForWindowExposed(&view));
+
+        for (int i = 0; i < model.rowCount(); i++)
+        {
+            auto index = model.index(i, 0);
+            auto rect = view.visualRect(index);
+            QVERIFY(!rect.isEmpty());
+            QCOMPARE(view.indexAt(rect.center()), index);
+        }
+        QVERIFY(!view.indexAt(QPoint(-10, -10)).isValid());
+    }
+
+    void test_paintOnlyExposed()
+    {
+        QStandardItemModel model;
+        fillModel(model, 500, 30);
+        CountingDelegate delegate;
+        InstanceView view;
+        view.setItemDelegate(&delegate);
+        view.setModel(&model);
+        view.resize(640, 480);
+        view.show();
+        QVERIFY(QTest::qWaitForWindowExposed(&view));
+
+        for (auto scroll : {0, view.verticalScrollBar()->maximum() / 2, view.verticalScrollBar()->maximum()})
+        {
+            view.verticalScrollBar()->setValue(scroll);
+            delegate.painted.clear();
+            QPixmap pixmap(view.viewport()->size());
+            view.viewport()->render(&pixmap);
+
+            QVERIFY(!delegate.painted.isEmpty());
+            QVERIFY(delegate.painted.size() < model.rowCount());
+            for (auto & item : delegate.painted)
+            {
+                QVERIFY(item.second.intersects(view.viewport()->rect()));
+                QCOMPARE(item.second, view.visualRect(item.first));
+            }
+            // and nothing visible was skipped
+            for (int i = 0; i < model.rowCount(); i++)
+            {
+                auto index = model.index(i, 0);
+                if (view.visualRect(index).intersects(view.viewport()->rect()))
+                {
+                    bool found = false;
+                    for (auto & item : delegate.painted)
+                    {
+                        found |= item.first == index;
+                    }
+                    QVERIFY(found);
+                }
+            }
+        }
+    }
+
+    void benchmark_paint_data()
+    {
+        QTest::addColumn<int>("count");
+        QTest::newRow("50 instances") << 50;
+        QTest::newRow("500 instances") << 500;
+        QTest::newRow("5000 instances") << 5000;
+    }
+    void benchmark_paint()
+    {
+        QFETCH(int, count);
+        QStandardItemModel model;
+        fillModel(model, count, 30);
+        ListViewDelegate delegate;
+        InstanceView view;
+        view.setItemDelegate(&delegate);
+        view.setModel(&model);
+        view.resize(800, 600);
+        view.show();
+        QVERIFY(QTest::qWaitForWindowExposed(&view));
+        view.verticalScrollBar()->setValue(view.verticalScrollBar()->maximum() / 2);
+
+        QPixmap pixmap(view.viewport()->size());
+        QBENCHMARK
+        {
+            view.viewport()->render(&pixmap);
+        }
+    }
+};
+
+int main(int argc, char *argv[])
+{
+    // the test doesn't need a real display
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+    {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+    InstanceViewTest test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "InstanceView_test.moc"
@@ -32,10 +32,10 @@ VisualGroup::VisualGroup(const VisualGroup *other)
 {
 }
 
-void VisualGroup::update()
+void VisualGroup::update(const QList<QModelIndex> &temp_items)
 {
-    auto temp_items = items();
     auto itemsPerRow = view->itemsPerRow();
+    auto option = view->viewOptions();
 
     int numRows = qMax(1, qCeil((qreal)temp_items.size() / (qreal)itemsPerRow));
     rows = QVector<VisualRow>(numRows);
@@ -55,12 +55,13 @@ void VisualGroup::update()
             positionInRow = 0;
             maxRowHeight = 0;
         }
-        auto itemHeight = view->itemDelegate()->sizeHint(view->viewOptions(), item).height();
-        if(itemHeight > maxRowHeight)
+        auto itemSize = view->itemDelegate()->sizeHint(option, item);
+        if(itemSize.height() > maxRowHeight)
         {
-            maxRowHeight = itemHeight;
+            maxRowHeight = itemSize.height();
         }
         rows[currentRow].items.append(item);
+        rows[currentRow].sizes.append(itemSize);
         positionInRow++;
     }
     rows[currentRow].height = maxRowHeight;
@@ -301,17 +302,3 @@ int VisualGroup::verticalPosition() const
 {
     return m_verticalPosition;
 }
-
-QList<QModelIndex> VisualGroup::items() const
-{
-    QList<QModelIndex> indices;
-    for (int i = 0; i < view->model()->rowCount(); ++i)
-    {
-        const QModelIndex index = view->model()->index(i, 0);
-        if (index.data(InstanceViewRoles::GroupRole).toString() == text)
-        {
-            indices.append(index);
-        }
-    }
-    return indices;
-}
@@ -27,6 +27,8 @@ class QModelIndex;
 struct VisualRow
 {
     QList<QModelIndex> items;
+    /// size hint of each item, in the same order
+    QVector<QSize> sizes;
     int height = 0;
     int top = 0;
     inline int size() const
@@ -54,8 +56,8 @@ struct VisualGroup
     int m_verticalPosition = 0;
 
 /* logic */
-    /// update the internal list of items and flow them into the rows.
-    void update();
+    /// flow the given items into the rows.
+    void update(const QList<QModelIndex> &items);
 
     /// draw the header at y-position.
     void drawHeader(QPainter *painter, const QStyleOptionViewItem &option);
@@ -99,8 +101,6 @@ struct VisualGroup
 
     /// shoot! BANG! what did we hit?
     HitResults hitScan (const QPoint &pos) const;
-
-    QList<QModelIndex> items() const;
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(VisualGroup::HitResults)
@@ -219,6 +219,7 @@ void LauncherPage::applySettings()
     s->set("ConsoleFontSize", ui->fontSizeBox->value());
     s->set("ConsoleMaxLines", ui->lineLimitSpinBox->value());
     s->set("ConsoleOverflowStop", ui->checkStopLogging->checkState() != Qt::Unchecked);
+    s->set("ConsoleLogToDisk", ui->checkLogToDisk->checkState() != Qt::Unchecked);
 
     // Folders
     // TODO: Offer to move instances to new instance folder.
@@ -321,6 +322,7 @@ void LauncherPage::loadSettings()
     refreshFontPreview();
     ui->lineLimitSpinBox->setValue(s->get("ConsoleMaxLines").toInt());
     ui->checkStopLogging->setChecked(s->get("ConsoleOverflowStop").toBool());
+    ui->checkLogToDisk->setChecked(s->get("ConsoleLogToDisk").toBool());
 
     // Folders
     ui->instDirTextBox->setText(s->get("InstanceDir").toString());
@@ -161,9 +161,22 @@ LogPage::LogPage(InstancePtr instance, QWidget *parent)
 
 LogPage::~LogPage()
 {
+    setViewVisible(false);
     delete ui;
 }
 
+void LogPage::showEvent(QShowEvent* event)
+{
+    QWidget::showEvent(event);
+    setViewVisible(true);
+}
+
+void LogPage::hideEvent(QHideEvent* event)
+{
+    QWidget::hideEvent(event);
+    setViewVisible(false);
+}
+
 void LogPage::modelStateToUI()
 {
     if(m_model->wrapLines())
@@ -199,9 +212,13 @@ void LogPage::UIToModelState()
 void LogPage::setInstanceLaunchTaskChanged(shared_qobject_ptr<LaunchTask> proc, bool initial)
 {
     m_process = proc;
+    setViewVisible(false);
     if(m_process)
     {
         m_model = proc->getLogModel();
+        setViewVisible(isVisible());
+        // a log kept on disk can be far larger than what the view should hold
+        ui->text->setWindowSize(m_model->isStoreBacked() ? m_model->getMaxLines() : 0);
         m_proxy->setSourceModel(m_model.get());
         if(initial)
         {
@@ -219,6 +236,23 @@ void LogPage::setInstanceLaunchTaskChanged(shared_qobject_ptr<LaunchTask> proc,
     }
 }
 
+void LogPage::setViewVisible(bool visible)
+{
+    if(!m_model || visible == m_viewVisible)
+    {
+        return;
+    }
+    m_viewVisible = visible;
+    if(visible)
+    {
+        m_model->addVisibleView();
+    }
+    else
+    {
+        m_model->removeVisibleView();
+    }
+}
+
 void LogPage::onInstanceLaunchTaskChanged(shared_qobject_ptr<LaunchTask> proc)
 {
     setInstanceLaunchTaskChanged(proc, false);
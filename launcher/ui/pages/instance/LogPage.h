@@ -55,6 +55,10 @@ public:
     }
     virtual bool shouldDisplay() const override;
 
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
 private slots:
     void on_btnPaste_clicked();
     void on_btnCopy_clicked();
@@ -75,6 +79,8 @@ private:
     void modelStateToUI();
     void UIToModelState();
     void setInstanceLaunchTaskChanged(shared_qobject_ptr<LaunchTask> proc, bool initial);
+    /// keep the model's count of visible views in line with this page
+    void setViewVisible(bool visible);
 
 private:
     Ui::LogPage *ui;
@@ -83,4 +89,6 @@ private:
 
     LogFormatProxyModel * m_proxy;
     shared_qobject_ptr <LogModel> m_model;
+    // this page is counted as a visible view of m_model
+    bool m_viewVisible = false;
 };
@@ -61,15 +61,53 @@ void LogView::modelDestroyed(QObject* model)
     }
 }
 
+void LogView::setWindowSize(int rows)
+{
+    if(m_windowSize == rows)
+    {
+        return;
+    }
+    m_windowSize = rows;
+    repopulate();
+}
+
 void LogView::repopulate()
 {
-    auto doc = document();
-    doc->clear();
     if(!m_model)
     {
+        document()->clear();
+        m_firstRow = 0;
+        m_shownRows = 0;
         return;
     }
-    rowsInserted(QModelIndex(), 0, m_model->rowCount() - 1);
+    int count = m_model->rowCount();
+    int first = 0;
+    if(m_windowSize > 0 && count > m_windowSize)
+    {
+        first = count - m_windowSize;
+    }
+    populate(first, count - 1);
+}
+
+void LogView::populate(int first, int last)
+{
+    document()->clear();
+    m_firstRow = first;
+    m_shownRows = 0;
+    if(m_model && last >= first)
+    {
+        appendRows(QModelIndex(), first, last);
+    }
+}
+
+void LogView::showRow(int row)
+{
+    int count = m_model->rowCount();
+    int first = qBound(0, row - m_windowSize / 2, qMax(0, count - m_windowSize));
+    populate(first, qMin(count, first + m_windowSize) - 1);
+    auto cursor = textCursor();
+    cursor.setPosition(document()->findBlockByNumber(row - m_firstRow).position());
+    setTextCursor(cursor);
 }
 
 void LogView::rowsAboutToBeInserted(const QModelIndex& parent, int first, int last)
@@ -92,6 +130,20 @@ void LogView::rowsAboutToBeInserted(const QModelIndex& parent, int first, int la
 
 void LogView::rowsInserted(const QModelIndex& parent, int first, int last)
 {
+    if(m_windowSize > 0 && first != m_firstRow + m_shownRows)
+    {
+        // showing older rows because of a search, the new ones show up when scrolled to the bottom
+        return;
+    }
+    appendRows(parent, first, last);
+}
+
+void LogView::appendRows(const QModelIndex& parent, int first, int last)
+{
+    // one edit block per batch of rows, so the document lays out once
+    auto workCursor = textCursor();
+    workCursor.movePosition(QTextCursor::End);
+    workCursor.beginEditBlock();
     for(int i = first; i <= last; i++)
     {
         auto idx = m_model->index(i, 0, parent);
@@ -112,11 +164,21 @@ void LogView::rowsInserted(const QModelIndex& parent, int first, int last)
         {
             format.setBackground(bg.value<QColor>());
         }
-        auto workCursor = textCursor();
-        workCursor.movePosition(QTextCursor::End);
         workCursor.insertText(text, format);
         workCursor.insertBlock();
     }
+    m_shownRows += last - first + 1;
+    if(m_windowSize > 0 && m_shownRows > m_windowSize)
+    {
+        // drop the oldest rows from the window
+        int excess = m_shownRows - m_windowSize;
+        workCursor.movePosition(QTextCursor::Start);
+        workCursor.movePosition(QTextCursor::NextBlock, QTextCursor::KeepAnchor, excess);
+        workCursor.removeSelectedText();
+        m_firstRow += excess;
+        m_shownRows -= excess;
+    }
+    workCursor.endEditBlock();
     if(m_scroll && !m_scrolling)
     {
         m_scrolling = true;
@@ -135,10 +197,43 @@ void LogView::rowsRemoved(const QModelIndex& parent, int first, int last)
 void LogView::scrollToBottom()
 {
     m_scrolling = false;
+    if(m_model && m_windowSize > 0 && m_firstRow + m_shownRows < m_model->rowCount())
+    {
+        repopulate();
+    }
     verticalScrollBar()->setSliderPosition(verticalScrollBar()->maximum());
 }
 
-void LogView::findNext(const QString& what, bool reverse)
+bool LogView::findNext(const QString& what, bool reverse)
 {
-    find(what, reverse ? QTextDocument::FindFlag::FindBackward : QTextDocument::FindFlag(0));
+    if(find(what, reverse ? QTextDocument::FindFlag::FindBackward : QTextDocument::FindFlag(0)))
+    {
+        return true;
+    }
+    if(!m_model || m_windowSize <= 0 || what.isEmpty())
+    {
+        return false;
+    }
+    // not in the window, go through the rows outside of it
+    int count = m_model->rowCount();
+    int outside = count - m_shownRows;
+    for(int i = 1; i <= outside; i++)
+    {
+        int row;
+        if(reverse)
+        {
+            row = (m_firstRow - i + count) % count;
+        }
+        else
+        {
+            row = (m_firstRow + m_shownRows - 1 + i) % count;
+        }
+        auto text = m_model->data(m_model->index(row, 0), Qt::DisplayRole).toString();
+        if(text.contains(what, Qt::CaseInsensitive))
+        {
+            showRow(row);
+            return find(what);
+        }
+    }
+    return false;
 }
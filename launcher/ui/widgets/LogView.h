@@ -16,9 +16,16 @@ public:
 
 public slots:
     void setWordWrap(bool wrapping);
-    void findNext(const QString & what, bool reverse);
+    bool findNext(const QString & what, bool reverse);
     void scrollToBottom();
 
+public:
+    /**
+     * Show at most this many rows of the model at once, 0 means all of them.
+     * Searching still goes through all rows and moves the window to the match.
+     */
+    void setWindowSize(int rows);
+
 protected slots:
     void repopulate();
     // note: this supports only appending
@@ -28,9 +35,18 @@ protected slots:
     void rowsRemoved(const QModelIndex &parent, int first, int last);
     void modelDestroyed(QObject * model);
 
+protected:
+    void populate(int first, int last);
+    void appendRows(const QModelIndex &parent, int first, int last);
+    void showRow(int row);
+
 protected:
     QAbstractItemModel *m_model = nullptr;
     QTextCharFormat *m_defaultFormat = nullptr;
     bool m_scroll = false;
     bool m_scrolling = false;
+    int m_windowSize = 0;
+    // model rows currently in the document
+    int m_firstRow = 0;
+    int m_shownRows = 0;
 };
@@ -69,6 +69,9 @@ DistributionInfo getDistributionInfo();
 
 uint64_t getSystemRam();
 
+/// Memory that can be used without swapping, in bytes. 0 if it can't be determined.
+uint64_t getAvailableRam();
+
 Architecture systemArchitecture();
 
 bool isSystem64bit();
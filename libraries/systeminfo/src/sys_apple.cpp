@@ -1,6 +1,7 @@
 #include "sys.h"
 
 #include <sys/utsname.h>
+#include <mach/mach.h>
 
 #include <QString>
 #include <QStringList>
@@ -55,6 +56,20 @@ uint64_t Sys::getSystemRam()
     }
 }
 
+uint64_t Sys::getAvailableRam()
+{
+    vm_statistics64_data_t stats;
+    mach_msg_type_number_t count = HOST_VM_INFO64_COUNT;
+    vm_size_t pageSize = 0;
+    if(host_statistics64(mach_host_self(), HOST_VM_INFO64, (host_info64_t)&stats, &count) != KERN_SUCCESS
+        || host_page_size(mach_host_self(), &pageSize) != KERN_SUCCESS)
+    {
+        return 0;
+    }
+    // inactive pages are given up without swapping
+    return (uint64_t(stats.free_count) + stats.inactive_count) * pageSize;
+}
+
 bool Sys::isCPU64bit()
 {
     // not even going to pretend I'm going to support anything else
@@ -82,6 +82,29 @@ uint64_t Sys::getSystemRam()
     return 0; // nothing found
 }
 
+uint64_t Sys::getAvailableRam()
+{
+#ifdef Q_OS_LINUX
+    std::string token;
+    std::ifstream file("/proc/meminfo");
+    while(file >> token)
+    {
+        if(token == "MemAvailable:")
+        {
+            uint64_t mem;
+            if(file >> mem)
+            {
+                return mem * 1024ull;
+            }
+            return 0;
+        }
+        // ignore rest of the line
+        file.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+#endif
+    return 0; // nothing found
+}
+
 bool Sys::isCPU64bit()
 {
     return isSystem64bit();
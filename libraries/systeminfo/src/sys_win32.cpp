@@ -34,6 +34,18 @@ uint64_t Sys::getSystemRam()
     return (uint64_t)status.ullTotalPhys;
 }
 
+uint64_t Sys::getAvailableRam()
+{
+    MEMORYSTATUSEX status;
+    status.dwLength = sizeof(status);
+    if(!GlobalMemoryStatusEx( &status ))
+    {
+        return 0;
+    }
+    // bytes
+    return (uint64_t)status.ullAvailPhys;
+}
+
 bool Sys::isSystem64bit()
 {
 #if defined(_WIN64)